@@ -0,0 +1,97 @@
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Core/Combat/CbtActivity.h"
+#include "Test.h"
+
+/* Active time of the live tracker against the finalized one, and a reader on another thread
+ * while hits come in. The UI thread reads the live encounter through ActiveTime() only. */
+
+#define HIT_COUNT 1000000 // Keeps the fight within 32-bit milliseconds.
+
+/* Reference, sums the gaps directly. */
+static uint32_t Expected(const std::vector<uint32_t>& aHits, uint32_t aDuration, uint32_t aThreshold)
+{
+	uint64_t idle = 0;
+	uint32_t last = 0;
+
+	for (uint32_t hit : aHits)
+	{
+		if (hit <= last) { continue; }
+		if (hit - last > aThreshold) { idle += hit - last; }
+		last = hit;
+	}
+
+	if (aDuration > last && aDuration - last > aThreshold) { idle += aDuration - last; }
+
+	return aDuration > idle ? (uint32_t)(aDuration - idle) : 0;
+}
+
+int main()
+{
+	/* Threshold changes apply to the whole fight at once, not from the next hit on. */
+	{
+		ActivityTracker_t activity;
+		std::vector<uint32_t> hits = { 3000, 3500, 10000, 12500, 12900, 30000 };
+
+		for (uint32_t hit : hits) { activity.OnHit(hit); }
+
+		for (uint32_t second = 1; second <= 20; second++)
+		{
+			CHECK(activity.ActiveTime(32000, second * 1000) == Expected(hits, 32000, second * 1000));
+		}
+
+		/* Below the minimum gap counts as the minimum, above the largest live threshold as the largest. */
+		CHECK(activity.ActiveTime(32000, 0) == Expected(hits, 32000, ACTIVITY_MIN_GAP));
+		CHECK(activity.ActiveTime(32000, 90000) == Expected(hits, 32000, ACTIVITY_MAX_SECOND * 1000));
+
+		activity.Finalize();
+
+		for (uint32_t threshold : { 1000u, 2500u, 6499u, 6500u, 17100u, 90000u })
+		{
+			CHECK(activity.ActiveTime(32000, threshold) == Expected(hits, 32000, threshold));
+		}
+	}
+
+	/* A reader never sees a hit time without the gap it closed. Gaps of 5s or 2s alternate, every
+	 * closed gap is idle at a 1s threshold, so active time is exactly the short gaps plus the open one. */
+	{
+		ActivityTracker_t activity;
+		std::atomic<bool> isDone = false;
+		std::atomic<uint32_t> errors = 0;
+		std::atomic<uint32_t> reads = 0;
+
+		std::thread reader([&]
+		{
+			while (!isDone.load())
+			{
+				uint32_t active = activity.ActiveTime(UINT32_MAX, 1000);
+
+				if (active != 0) { errors++; }
+				reads++;
+			}
+		});
+
+		uint32_t time = 0;
+
+		for (uint32_t i = 0; i < HIT_COUNT; i++)
+		{
+			time += i & 1 ? 2000 : 5000;
+			activity.OnHit(time);
+		}
+
+		isDone.store(true);
+		reader.join();
+
+		std::printf("%u hits, %u concurrent reads\n", HIT_COUNT, reads.load());
+
+		CHECK(errors.load() == 0);
+		CHECK(activity.ActiveTime(time, 1000) == 0);
+		CHECK(activity.ActiveTime(time, 3000) == time / 7000 * 2000);
+	}
+
+	return TestResult();
+}
@@ -0,0 +1,117 @@
+/* Buff uptime: removals reporting expiries, duration stacking and carried pre-pull stacks. */
+#include "Test.h"
+
+#include "Core/Combat/CbtBuffs.h"
+
+/* The game sends a removal for a stack that ran out, it must not end a second stack. */
+static void ExpiryRemoval()
+{
+	BuffUptime_t might;
+	might.Apply(0, 5000);
+	might.Apply(1000, 5000);
+	might.Remove(5000);
+	might.Remove(6000);
+	might.Finalize(10000);
+
+	CHECK(might.Covered == 6000);
+	CHECK(might.StackTime == 1000 + 2 * 4000 + 1000);
+	CHECK(might.MaxStacks == 2);
+
+	/* Arriving a little late still reports the expiry. */
+	BuffUptime_t late;
+	late.Apply(0, 5000);
+	late.Apply(1000, 5000);
+	late.Remove(5040);
+	late.Finalize(10000);
+
+	CHECK(late.Covered == 6000);
+}
+
+/* Removals without an expiry nearby end the stack closest to expiring. */
+static void ManualRemoval()
+{
+	BuffUptime_t might;
+	might.Apply(0, 5000);
+	might.Apply(1000, 5000);
+	might.Remove(2000);
+	might.Finalize(10000);
+
+	CHECK(might.Covered == 6000);
+	CHECK(might.StackTime == 1000 + 2 * 1000 + 4000);
+
+	/* An expiry long ago does not swallow a later cleanse. */
+	BuffUptime_t cleansed;
+	cleansed.Apply(0, 1000);
+	cleansed.Apply(500, 10000);
+	cleansed.Remove(4000);
+	cleansed.Finalize(20000);
+
+	CHECK(cleansed.Covered == 4000);
+}
+
+/* Duration stacks queue up, only one counts at a time. */
+static void DurationStacking()
+{
+	static_assert(Buffs::GetStacking(1187) == EBuffStacking::Duration, "Quickness stacks in duration.");
+	static_assert(Buffs::GetStacking(740) == EBuffStacking::Intensity, "Might stacks in intensity.");
+
+	BuffUptime_t quickness;
+	quickness.Stacking = EBuffStacking::Duration;
+	quickness.Apply(0, 5000);
+	quickness.Apply(1000, 5000);
+	quickness.Remove(5000);
+	quickness.Remove(10000);
+	quickness.Finalize(20000);
+
+	CHECK(quickness.Covered == 10000);
+	CHECK(quickness.StackTime == 10000);
+	CHECK(quickness.MaxStacks == 1);
+
+	/* Ending the running stack early starts the queued one. */
+	BuffUptime_t stripped;
+	stripped.Stacking = EBuffStacking::Duration;
+	stripped.Apply(0, 5000);
+	stripped.Apply(1000, 5000);
+	stripped.Remove(2000);
+	stripped.Finalize(20000);
+
+	CHECK(stripped.Covered == 7000);
+
+	/* A queue that ran dry starts over at the next application. */
+	BuffUptime_t gap;
+	gap.Stacking = EBuffStacking::Duration;
+	gap.Apply(0, 1000);
+	gap.Apply(3000, 1000);
+	gap.Finalize(20000);
+
+	CHECK(gap.Covered == 2000);
+}
+
+/* Stacks applied before the pull continue in the encounter. */
+static void Carry()
+{
+	BuffUptime_t prepull;
+	prepull.Apply(0, 10000);
+	prepull.Apply(1000, 2000);
+	prepull.Apply(2000, 0);
+
+	BuffUptime_t uptime;
+	uptime.Carry(prepull, 4000);
+
+	CHECK(uptime.Stacks() == 2);
+
+	uptime.Finalize(20000);
+
+	CHECK(uptime.Covered == 20000);
+	CHECK(uptime.StackTime == 2 * 6000 + 14000);
+}
+
+int main()
+{
+	ExpiryRemoval();
+	ManualRemoval();
+	DurationStacking();
+	Carry();
+
+	return TestResult();
+}
@@ -0,0 +1,92 @@
+/* Releasing encounters while the comparison worker reads them. The render thread
+ * releases with the UI mutex held, it must never wait for the worker. */
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "Test.h"
+
+/* Defines max() like windows.h, include after the standard headers. */
+#include "Core/Comparison.h"
+#include "Core/Combat/CbtEncounter.h"
+
+#define SKILL_COUNT 50000 // Keeps the worker busy for tens of ms.
+#define ROUND_COUNT 10
+
+static std::atomic<uint32_t>        s_Freed = 0;
+static std::atomic<std::thread::id> s_FreedOn;
+
+static Encounter_t* MakeEncounter(uint64_t aDuration)
+{
+	Encounter_t* encounter = new Encounter_t();
+	encounter->TimeEnd = aDuration;
+
+	for (uint32_t id = 1; id <= SKILL_COUNT; id++)
+	{
+		Skill_t* skill = new Skill_t();
+		skill->ID = id;
+		skill->Out.Hits = 1;
+		skill->Out.Damage = -(float)id;
+		encounter->Skills.Set(id, skill);
+	}
+
+	return encounter;
+}
+
+static void FreeEncounter(Encounter_t* aEncounter)
+{
+	aEncounter->Skills.ForEach([](uint32_t, Skill_t* aSkill)
+	{
+		delete aSkill;
+	});
+
+	delete aEncounter;
+
+	s_FreedOn.store(std::this_thread::get_id());
+	s_Freed++;
+}
+
+int main()
+{
+	Comparison::Create();
+
+	uint32_t deferred = 0;
+	double   slowest  = 0.;
+
+	for (uint32_t round = 0; round < ROUND_COUNT; round++)
+	{
+		Encounter_t* a = MakeEncounter(60000);
+		Encounter_t* b = MakeEncounter(30000);
+
+		/* Queues the diff, the worker picks it up. */
+		CHECK(Comparison::Get(a, b) == nullptr);
+		std::this_thread::sleep_for(std::chrono::milliseconds(round % 2));
+
+		auto start = std::chrono::steady_clock::now();
+		Comparison::Release(a, FreeEncounter);
+		double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		slowest = elapsed > slowest ? elapsed : slowest;
+
+		/* Wait for the worker to finish, then the survivor goes the same way. */
+		while (s_Freed.load() != round * 2 + 1)
+		{
+			std::this_thread::yield();
+		}
+
+		if (s_FreedOn.load() != std::this_thread::get_id()) { deferred++; }
+
+		Comparison::Release(b, FreeEncounter);
+		CHECK(s_Freed.load() == round * 2 + 2);
+		CHECK(s_FreedOn.load() == std::this_thread::get_id());
+	}
+
+	Comparison::Destroy();
+
+	std::printf("%u of %u releases deferred to the worker, slowest release %.3f ms\n", deferred, ROUND_COUNT, slowest);
+
+	CHECK(deferred > 0);
+	CHECK(s_Freed.load() == ROUND_COUNT * 2);
+
+	return TestResult();
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* Stand-in for the Nexus DataLink allocation on Linux.
+ * Share() maps a zeroed block from a temporary file, Map() maps the same block
+ * again at another address, the way a consumer in another module sees it. */
+struct DataLink_t
+{
+	int    File = -1;
+	size_t Size = 0;
+
+	inline void* Share(size_t aSize)
+	{
+		char path[] = "/tmp/cmx_datalink_XXXXXX";
+		this->File = mkstemp(path);
+
+		if (this->File < 0) { return nullptr; }
+
+		/* Only the descriptor keeps the block alive, like a named mapping without a file. */
+		unlink(path);
+
+		if (ftruncate(this->File, (off_t)aSize) != 0) { return nullptr; }
+
+		this->Size = aSize;
+		return this->Map();
+	}
+
+	inline void* Map()
+	{
+		void* view = mmap(nullptr, this->Size, PROT_READ | PROT_WRITE, MAP_SHARED, this->File, 0);
+		return view == MAP_FAILED ? nullptr : view;
+	}
+
+	inline void Unmap(void* aView)
+	{
+		munmap(aView, this->Size);
+	}
+
+	inline ~DataLink_t()
+	{
+		if (this->File >= 0) { close(this->File); }
+	}
+};
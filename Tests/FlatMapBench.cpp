@@ -0,0 +1,116 @@
+/* Lookup benchmark of FlatMap_t against std::unordered_map on synthetic raid traffic.
+ * 300 agents with sequential IDs, 12 squad sources hitting 25 targets in bursts,
+ * 150 skills with sparse IDs. Prints ns per lookup, checks both maps agree. */
+#include "Test.h"
+
+#include "Core/FlatMap.h"
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#define AGENT_COUNT  300
+#define SOURCE_COUNT 12
+#define TARGET_COUNT 25
+#define SKILL_COUNT  150
+#define EVENT_COUNT  1000000
+#define ROUNDS       4
+
+struct Lookup_t
+{
+	uint32_t Src;
+	uint32_t Dst;
+	uint32_t Skill;
+};
+
+static std::vector<Lookup_t> GenerateEvents(const std::vector<uint32_t>& aAgents, const std::vector<uint32_t>& aSkills)
+{
+	std::mt19937 rng(1234);
+	std::vector<Lookup_t> events;
+	events.reserve(EVENT_COUNT);
+
+	Lookup_t current{};
+
+	for (size_t i = 0; i < EVENT_COUNT; i++)
+	{
+		/* A source keeps its target and skill for a few hits, like a skill's damage ticks. */
+		if (rng() % 4 == 0)
+		{
+			current.Src   = aAgents[rng() % SOURCE_COUNT];
+			current.Dst   = aAgents[SOURCE_COUNT + rng() % TARGET_COUNT];
+			current.Skill = aSkills[rng() % SKILL_COUNT];
+		}
+
+		events.push_back(current);
+	}
+
+	return events;
+}
+
+template<typename F>
+static double Measure(const char* aName, const std::vector<Lookup_t>& aEvents, uint64_t& aChecksum, F aLookup)
+{
+	uint64_t sum = 0;
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (uint32_t round = 0; round < ROUNDS; round++)
+	{
+		for (const Lookup_t& ev : aEvents)
+		{
+			sum += aLookup(ev.Src) + aLookup(ev.Dst) + aLookup(ev.Skill);
+		}
+	}
+
+	auto end = std::chrono::steady_clock::now();
+
+	double ns = std::chrono::duration<double, std::nano>(end - start).count() / ((double)aEvents.size() * ROUNDS * 3);
+	std::printf("%-22s %6.2f ns/lookup\n", aName, ns);
+
+	aChecksum = sum;
+	return ns;
+}
+
+int main()
+{
+	std::vector<uint32_t> agents;
+	std::vector<uint32_t> skills;
+
+	/* Agent IDs are handed out sequentially with gaps from despawned agents. */
+	for (uint32_t i = 0, id = 2000; i < AGENT_COUNT; i++, id += 1 + i % 3)
+	{
+		agents.push_back(id);
+	}
+
+	std::mt19937 rng(42);
+	for (uint32_t i = 0; i < SKILL_COUNT; i++)
+	{
+		skills.push_back(1000 + rng() % 70000);
+	}
+
+	FlatMap_t<uint32_t>                    flat;
+	std::unordered_map<uint32_t, uint32_t> unordered;
+
+	for (uint32_t id : agents) { flat.Set(id, id & 0xFF); unordered[id] = id & 0xFF; }
+	for (uint32_t id : skills) { flat.Set(id, id & 0xFF); unordered[id] = id & 0xFF; }
+
+	std::vector<Lookup_t> events = GenerateEvents(agents, skills);
+
+	uint64_t sumGet = 0, sumPeek = 0, sumUnordered = 0;
+
+	Measure("FlatMap_t::Get", events, sumGet, [&flat](uint32_t aKey) { return flat.Get(aKey); });
+	Measure("FlatMap_t::Peek", events, sumPeek, [&flat](uint32_t aKey) { return flat.Peek(aKey); });
+	Measure("std::unordered_map", events, sumUnordered, [&unordered](uint32_t aKey)
+	{
+		auto it = unordered.find(aKey);
+		return it != unordered.end() ? it->second : 0u;
+	});
+
+	CHECK(sumGet == sumUnordered);
+	CHECK(sumPeek == sumUnordered);
+	CHECK(flat.Size() == unordered.size());
+
+	return TestResult();
+}
@@ -0,0 +1,113 @@
+/* Formatting into fixed buffers, as the UI does every frame. Counts heap allocations
+ * over 1M rates, durations and encounter names, checks denominations around rounding. */
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "Test.h"
+
+/* Defines max() like windows.h, include after the standard headers. */
+#include "Core/Format.h"
+#include "Core/Combat/CbtEncounter.h"
+
+#define FORMAT_COUNT 1000000
+
+static std::atomic<uint64_t> s_Allocations = 0;
+
+void* operator new(size_t aSize)
+{
+	s_Allocations++;
+
+	if (void* ptr = std::malloc(aSize ? aSize : 1)) { return ptr; }
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* aPtr) noexcept
+{
+	std::free(aPtr);
+}
+
+void operator delete(void* aPtr, size_t) noexcept
+{
+	std::free(aPtr);
+}
+
+static bool Denominates(double aValue, const char* aExpected)
+{
+	char buffer[32];
+	Format::Denominated(buffer, sizeof(buffer), aValue, "/s");
+
+	if (strcmp(buffer, aExpected) == 0) { return true; }
+
+	std::printf("%.2f: \"%s\", expected \"%s\"\n", aValue, buffer, aExpected);
+	return false;
+}
+
+int main()
+{
+	/* The denomination follows the rounded number, not the raw one. */
+	CHECK(Denominates(0., "0/s"));
+	CHECK(Denominates(999.4, "999/s"));
+	CHECK(Denominates(999.6, "1.0k/s"));
+	CHECK(Denominates(999940., "999.9k/s"));
+	CHECK(Denominates(999960., "1.00M/s"));
+	CHECK(Denominates(999996000., "1.00B/s"));
+	CHECK(Denominates(-999960., "-1.00M/s"));
+	CHECK(Denominates(1234567., "1.23M/s"));
+	CHECK(Denominates(5e12, "5000.00B/s"));
+
+	/* A number that does not fit ends the string. */
+	char small[4];
+	CHECK(strcmp(Format::Denominated(small, sizeof(small), 999960., "/s"), "") == 0);
+
+	Encounter_t encounter;
+	encounter.TimeStart = 1700000000000ull;
+	encounter.TimeEnd   = encounter.TimeStart + 754250;
+	encounter.Group     = ESpeciesGroup::Wing4;
+	encounter.IsCM      = true;
+	strcpy(encounter.SpeciesName, "Deimos");
+
+	/* The trigger's name is not decoded yet, the species name stands in. */
+	encounter.AddAgent(100, nullptr);
+	encounter.TriggerID = 100;
+
+	char name[192];
+	encounter.GetName(name, sizeof(name));
+	CHECK(strstr(name, ", 12m34.25s (W4 Deimos CM)") == name + 8);
+	CHECK(name[2] == ':' && name[5] == ':');
+
+	char     rate[32];
+	char     duration[32];
+	uint64_t checksum = 0;
+
+	uint64_t allocations = s_Allocations.load();
+	auto start = std::chrono::steady_clock::now();
+
+	for (uint32_t i = 0; i < FORMAT_COUNT; i++)
+	{
+		double value = (double)i * 1013.;
+
+		checksum += strlen(Format::Denominated(rate, sizeof(rate), value, "/s"));
+		checksum += strlen(Format::Duration(duration, sizeof(duration), i * 37ull));
+
+		if (i % 64 == 0)
+		{
+			encounter.TimeEnd = encounter.TimeStart + i;
+			checksum += strlen(encounter.GetName(name, sizeof(name)));
+		}
+	}
+
+	double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	allocations = s_Allocations.load() - allocations;
+
+	std::printf("%.1f ns per rate and duration, %llu allocations, checksum %llu\n", elapsed / FORMAT_COUNT,
+		(unsigned long long)allocations, (unsigned long long)checksum);
+
+	CHECK(allocations == 0);
+
+	return TestResult();
+}
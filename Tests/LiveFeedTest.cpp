@@ -0,0 +1,133 @@
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "Core/Combat/LiveFeed.h"
+#include "DataLink.h"
+#include "Test.h"
+
+/* Seqlock of the live feed under a hot writer and concurrent readers on a second mapping.
+ * Every field of a publish is derived from its counter, a torn snapshot mixes counters. */
+
+#define PUBLISH_COUNT 2000000
+#define READER_COUNT  3
+
+static LiveFeedData_t MakeData(uint32_t aCounter)
+{
+	LiveFeedData_t data{};
+	data.IsActive   = 1;
+	data.SpeciesID  = aCounter;
+	data.TimeStart  = (uint64_t)aCounter << 20;
+	data.Duration   = aCounter * 3;
+	data.RollingDPS = (float)(aCounter & 0xFFFF);
+
+	for (LiveStats_t* stats : { &data.OutTarget, &data.OutCleave, &data.InTarget, &data.InCleave })
+	{
+		stats->Damage  = -(float)(aCounter & 0xFFFF);
+		stats->Heal    = (float)(aCounter & 0xFFF);
+		stats->Barrier = (float)(aCounter & 0xFF);
+	}
+
+	return data;
+}
+
+static bool IsConsistent(const LiveFeedData_t& aData)
+{
+	LiveFeedData_t expected = MakeData(aData.SpeciesID);
+	return std::memcmp(&expected, &aData, sizeof(LiveFeedData_t)) == 0;
+}
+
+int main()
+{
+	DataLink_t link;
+
+	void* shared = link.Share(sizeof(LiveFeed_t));
+	CHECK(shared != nullptr);
+	if (!shared) { return TestResult(); }
+
+	/* Set up like the addon does on load. */
+	LiveFeed_t* feed = new (shared) LiveFeed_t();
+	feed->Version = CMX_LIVE_VERSION;
+	feed->Size    = sizeof(LiveFeed_t);
+
+	/* Consumers see the block through their own view. */
+	const LiveFeed_t* view = (const LiveFeed_t*)link.Map();
+	CHECK(view != nullptr && view != feed);
+	if (!view) { return TestResult(); }
+
+	CHECK(view->Version == CMX_LIVE_VERSION);
+	CHECK(view->Size == sizeof(LiveFeed_t));
+
+	LiveFeedData_t initial{};
+	CHECK(view->Read(initial));
+	CHECK(initial.IsActive == 0);
+
+	std::atomic<bool>     isDone{ false };
+	std::atomic<uint32_t> torn{ 0 };
+	std::atomic<uint32_t> backwards{ 0 };
+	std::atomic<uint64_t> reads{ 0 };
+	std::atomic<uint64_t> misses{ 0 };
+
+	std::vector<std::thread> readers;
+	for (int r = 0; r < READER_COUNT; r++)
+	{
+		readers.emplace_back([&]()
+		{
+			uint32_t last = 0;
+
+			while (!isDone.load(std::memory_order_relaxed))
+			{
+				LiveFeedData_t data;
+
+				if (!view->Read(data))
+				{
+					misses++;
+					continue;
+				}
+
+				reads++;
+
+				if (data.IsActive && !IsConsistent(data)) { torn++; }
+				if (data.SpeciesID < last)                 { backwards++; }
+
+				last = data.SpeciesID;
+			}
+		});
+	}
+
+	/* Back to back publishes, then with a pause like the ingest between events. */
+	for (uint32_t i = 1; i <= PUBLISH_COUNT; i++)
+	{
+		feed->Write(MakeData(i));
+
+		if (i > PUBLISH_COUNT / 2)
+		{
+			for (uint32_t spin = 0; spin < 200; spin++)
+			{
+				(void)isDone.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	isDone = true;
+	for (std::thread& reader : readers) { reader.join(); }
+
+	std::printf("%llu reads, %llu gave up\n", (unsigned long long)reads.load(), (unsigned long long)misses.load());
+
+	CHECK(torn == 0);
+	CHECK(backwards == 0);
+	CHECK(reads > 0);
+
+	/* A quiet feed always reads the latest publish. */
+	LiveFeedData_t latest;
+	CHECK(view->Read(latest, 1));
+	CHECK(latest.SpeciesID == PUBLISH_COUNT && IsConsistent(latest));
+	CHECK(view->Sequence.load() == PUBLISH_COUNT * 2);
+
+	link.Unmap((void*)view);
+	link.Unmap(shared);
+
+	return TestResult();
+}
@@ -0,0 +1,267 @@
+#include <cstdint>
+#include <vector>
+
+#include "Core/Combat/CbtPhases.h"
+#include "Core/Combat/CbtEventLog.h"
+#include "Core/Combat/CbtTimeIndex.h"
+#include "Test.h"
+
+/* Synthetic streams fed into the phase tracker, checked against a time index of the same hits. */
+
+struct Hit_t
+{
+	uint32_t Time;
+	uint32_t SpeciesID;
+	float    Damage;
+};
+
+static Stats_t Damage(float aDamage)
+{
+	Stats_t stats{};
+	stats.Damage = aDamage;
+	return stats;
+}
+
+/* Time index bound to its own event log, like the indices of an encounter. */
+struct IndexedLog_t
+{
+	EventLog_t  Log;
+	TimeIndex_t Index;
+
+	IndexedLog_t()
+	{
+		this->Index.Bind(TIMEINDEX_CHANNEL_OUTTARGET);
+	}
+
+	void Add(uint32_t aTime, const Stats_t& aDelta)
+	{
+		CombatEvent_t event{};
+		event.Type  = ECombatEventType::Health;
+		event.Time  = aTime;
+		event.Value = aDelta.Damage;
+
+		this->Index.Add(*this->Log.Append(event), aTime, aDelta);
+	}
+};
+
+/* Every hit must land in exactly one phase window, also when hits share the split time. */
+static void CheckWindowsPartition(const PhaseTracker_t& aTracker, const TimeIndex_t& aIndex)
+{
+	double total = 0;
+
+	for (size_t i = 0; i < aTracker.Phases.size(); i++)
+	{
+		const Phase_t& phase = aTracker.Phases[i];
+
+		CHECK(phase.TimeStart <= phase.TimeEnd);
+
+		if (i > 0)
+		{
+			CHECK(aTracker.Phases[i - 1].TimeEnd < phase.TimeStart);
+		}
+
+		Stats_t window = aIndex.Query(phase.TimeStart, phase.TimeEnd);
+		CHECK(window.Damage == phase.OutTarget.Damage);
+		total += window.Damage;
+	}
+
+	CHECK(total == aIndex.Query(0, UINT32_MAX).Damage);
+}
+
+static void TestTimeGap()
+{
+	PhaseTracker_t tracker{};
+	tracker.Rule = PhaseRule_t{ 1, 5000, false, false };
+
+	IndexedLog_t index;
+
+	for (const Hit_t& hit : std::vector<Hit_t>{ { 0, 1, -10 }, { 1000, 1, -10 }, { 9000, 1, -20 }, { 9500, 1, -20 } })
+	{
+		tracker.OnOutgoing(hit.Time, hit.SpeciesID, true, Damage(hit.Damage));
+		index.Add(hit.Time, Damage(hit.Damage));
+	}
+
+	tracker.Finalize();
+	index.Index.Finalize(9500);
+
+	CHECK(tracker.Phases.size() == 2);
+	CHECK(tracker.Phases[0].TimeEnd == 1000);
+	CHECK(tracker.Phases[1].TimeStart == 9000);
+	CHECK(tracker.Phases[0].OutTarget.Damage == -20);
+	CHECK(tracker.Phases[1].OutTarget.Damage == -40);
+
+	CheckWindowsPartition(tracker, index.Index);
+}
+
+static void TestTargetSwap()
+{
+	PhaseTracker_t tracker{};
+	tracker.Rule = PhaseRule_t{ 1, 0, true, false };
+
+	IndexedLog_t index;
+
+	/* The swap at 2000 shares its ms with a hit on the old species, the new phase starts with the next hit. */
+	for (const Hit_t& hit : std::vector<Hit_t>{ { 0, 1, -10 }, { 2000, 1, -5 }, { 2000, 2, -7 }, { 3000, 2, -3 }, { 4000, 1, -1 } })
+	{
+		tracker.OnOutgoing(hit.Time, hit.SpeciesID, true, Damage(hit.Damage));
+		index.Add(hit.Time, Damage(hit.Damage));
+	}
+
+	tracker.Finalize();
+	index.Index.Finalize(4000);
+
+	CHECK(tracker.Phases.size() == 3);
+	CHECK(tracker.Phases[0].SpeciesID == 1);
+	CHECK(tracker.Phases[1].SpeciesID == 2);
+	CHECK(tracker.Phases[2].SpeciesID == 1);
+	CHECK(tracker.Phases[0].TimeEnd == 2000);
+	CHECK(tracker.Phases[1].TimeStart == 3000);
+	CHECK(tracker.Phases[1].TimeEnd == 3999);
+	CHECK(tracker.Phases[2].TimeStart == 4000);
+	CHECK(tracker.Phases[0].OutTarget.Damage == -22);
+	CHECK(tracker.Phases[1].OutTarget.Damage == -3);
+	CHECK(tracker.Phases[2].OutTarget.Damage == -1);
+
+	CheckWindowsPartition(tracker, index.Index);
+}
+
+static void TestTargetDeath()
+{
+	PhaseTracker_t tracker{};
+	tracker.Rule = PhaseRule_t{ 1, 0, false, true };
+
+	IndexedLog_t index;
+
+	auto hit = [&](uint32_t aTime, float aDamage)
+	{
+		tracker.OnOutgoing(aTime, 1, true, Damage(aDamage));
+		index.Add(aTime, Damage(aDamage));
+	};
+
+	hit(0, -10);
+	hit(4000, -10);
+	tracker.OnTargetDeath(5000, 10);
+	tracker.OnTargetDeath(5000, 11); // Second target dying in the same ms.
+	hit(5000, -30);
+	hit(6000, -30);
+
+	tracker.Finalize();
+	index.Index.Finalize(6000);
+
+	CHECK(tracker.Phases.size() == 2);
+	CHECK(tracker.Phases[0].TimeEnd == 4999);
+	CHECK(tracker.Phases[1].TimeStart == 5000);
+	CHECK(tracker.Phases[0].OutTarget.Damage == -20);
+	CHECK(tracker.Phases[1].OutTarget.Damage == -60);
+
+	CheckWindowsPartition(tracker, index.Index);
+}
+
+/* Going down splits, the death of the same target afterwards does not split again. */
+static void TestTargetDown()
+{
+	PhaseTracker_t tracker{};
+	tracker.Rule = PhaseRule_t{ 1, 0, false, true };
+
+	IndexedLog_t index;
+
+	auto hit = [&](uint32_t aTime, float aDamage)
+	{
+		tracker.OnOutgoing(aTime, 1, true, Damage(aDamage));
+		index.Add(aTime, Damage(aDamage));
+	};
+
+	hit(0, -10);
+	tracker.OnTargetDown(2000, 10);
+	hit(3000, -20);
+	tracker.OnTargetDeath(4000, 10);
+	hit(5000, -30);
+	tracker.OnTargetDeath(6000, 11);
+	hit(7000, -40);
+
+	tracker.Finalize();
+	index.Index.Finalize(7000);
+
+	CHECK(tracker.Phases.size() == 3);
+	CHECK(tracker.Phases[0].TimeEnd == 1999);
+	CHECK(tracker.Phases[1].TimeStart == 2000);
+	CHECK(tracker.Phases[1].OutTarget.Damage == -50);
+	CHECK(tracker.Phases[2].TimeStart == 6000);
+	CHECK(tracker.Phases[2].OutTarget.Damage == -40);
+
+	CheckWindowsPartition(tracker, index.Index);
+}
+
+static void TestTrailingPhaseDropped()
+{
+	PhaseTracker_t tracker{};
+	tracker.Rule = PhaseRule_t{ 1, 0, false, true };
+
+	tracker.OnOutgoing(0, 1, true, Damage(-10));
+	tracker.OnTargetDeath(1000, 10);
+	tracker.Finalize();
+
+	CHECK(tracker.Phases.size() == 1);
+	CHECK(tracker.Phases[0].TimeEnd == 999);
+}
+
+/* Long stream with all rules enabled, the phase windows still partition the index. */
+static void TestSyntheticStream()
+{
+	PhaseTracker_t tracker{};
+	tracker.Rule = PhaseRule_t{ 1, 3000, true, true };
+
+	IndexedLog_t index;
+	uint32_t    seed = 12345;
+	uint32_t    time = 0;
+
+	for (int i = 0; i < 20000; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+
+		time += (seed >> 16) % 7 == 0 ? (seed >> 8) % 5000 : (seed >> 8) % 3;
+
+		if ((seed >> 4) % 997 == 0)
+		{
+			tracker.OnTargetDeath(time, 10);
+			continue;
+		}
+
+		uint32_t species = 1 + (seed >> 20) % 3;
+		float    damage  = -(float)((seed >> 12) % 1000);
+
+		tracker.OnOutgoing(time, species, true, Damage(damage));
+		index.Add(time, Damage(damage));
+	}
+
+	tracker.Finalize();
+	index.Index.Finalize(time);
+
+	CHECK(tracker.Phases.size() > 10);
+
+	/* Damages are integers well below 2^24, float sums stay exact enough to compare via doubles. */
+	double total = 0;
+	for (const Phase_t& phase : tracker.Phases)
+	{
+		total += phase.OutTarget.Damage;
+	}
+
+	CHECK(total == index.Index.Query(0, time).Damage);
+
+	for (size_t i = 1; i < tracker.Phases.size(); i++)
+	{
+		CHECK(tracker.Phases[i - 1].TimeEnd < tracker.Phases[i].TimeStart);
+	}
+}
+
+int main()
+{
+	TestTimeGap();
+	TestTargetSwap();
+	TestTargetDeath();
+	TestTargetDown();
+	TestTrailingPhaseDropped();
+	TestSyntheticStream();
+
+	return TestResult();
+}
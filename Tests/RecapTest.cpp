@@ -0,0 +1,58 @@
+/* Death recap ring, window filtering and truncation. */
+#include "Test.h"
+
+#include "Core/Combat/CbtRecap.h"
+
+#include <memory>
+
+static void WindowOnly()
+{
+	RecapRing_t ring;
+
+	for (uint64_t t = 0; t < 20000; t += 1000)
+	{
+		ring.Push(RecapHit_t{ t, nullptr, nullptr, -1.f });
+	}
+
+	auto recap = std::make_unique<DeathRecap_t>();
+	ring.Freeze(*recap, ECombatEventType::Death, 20000);
+
+	CHECK(recap->Count == 10);
+	CHECK(recap->Hits[0].Time == 10000);
+	CHECK(!recap->IsTruncated);
+}
+
+static void Overflow()
+{
+	RecapRing_t ring;
+
+	/* Twice the capacity within a second. */
+	for (uint64_t t = 0; t < RECAP_CAPACITY * 2; t++)
+	{
+		ring.Push(RecapHit_t{ 5000 + t, nullptr, nullptr, -1.f });
+	}
+
+	auto recap = std::make_unique<DeathRecap_t>();
+	ring.Freeze(*recap, ECombatEventType::Down, 6000);
+
+	CHECK(recap->Count == RECAP_CAPACITY);
+	CHECK(recap->IsTruncated);
+
+	/* Overwritten hits older than the window do not truncate. */
+	ring.Freeze(*recap, ECombatEventType::Down, 5000 + RECAP_CAPACITY + RECAP_WINDOW + 1);
+	CHECK(!recap->IsTruncated);
+
+	ring.Clear();
+	ring.Push(RecapHit_t{ 7000, nullptr, nullptr, -1.f });
+	ring.Freeze(*recap, ECombatEventType::Down, 7000);
+	CHECK(recap->Count == 1);
+	CHECK(!recap->IsTruncated);
+}
+
+int main()
+{
+	WindowOnly();
+	Overflow();
+
+	return TestResult();
+}
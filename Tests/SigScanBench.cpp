@@ -0,0 +1,91 @@
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Core/SigScan.h"
+#include "Test.h"
+
+/* Cold path: resolving four signatures in a 48 MB image, single pass against one
+ * pass per pattern. Warm path: verifying four cached addresses by fingerprint. */
+
+#define IMAGE_SIZE (48u << 20)
+
+int main()
+{
+	/* Code-like byte distribution, prologue and prefix bytes dominate. */
+	static const uint8_t s_Common[] = { 0x48, 0x8B, 0x89, 0x4C, 0x24, 0x00, 0xCC, 0xE8, 0x0F, 0x83 };
+
+	std::mt19937 rng(42);
+	std::vector<uint8_t> image(IMAGE_SIZE);
+	for (uint8_t& byte : image)
+	{
+		uint32_t r = rng();
+		byte = r % 3 ? s_Common[(r >> 8) % sizeof(s_Common)] : (uint8_t)(r >> 16);
+	}
+
+	static const char* const s_Patterns[] = { "40 53 48 83 EC 20 ?? 8B D9 48 8D", "E8 ?? ?? ?? ?? 48 8B 5C 24 30 48 83 C4 20 5F C3", "48 8D 0D ?? ?? ?? ?? E8 ?? ?? ?? ?? 84 C0 74", "41 B8 ?? 00 00 00 BA ?? ?? ?? ?? 48 8B CB" };
+
+	std::vector<SigPattern_t> patterns(4);
+	for (size_t p = 0; p < patterns.size(); p++)
+	{
+		patterns[p].Parse(s_Patterns[p]);
+
+		/* Late in the image, like functions deep in the text section. */
+		size_t offset = IMAGE_SIZE - (p + 1) * (IMAGE_SIZE / 16);
+		for (size_t i = 0; i < patterns[p].Bytes.size(); i++)
+		{
+			if (patterns[p].Mask[i]) { image[offset + i] = patterns[p].Bytes[i]; }
+		}
+	}
+
+	/* One pass per pattern, like scanning each signature on its own. */
+	auto start = std::chrono::steady_clock::now();
+
+	std::vector<const uint8_t*> separate;
+	for (SigPattern_t pattern : patterns)
+	{
+		SigScan::ScanAll(image.data(), image.size(), &pattern, 1);
+		separate.push_back(pattern.Result);
+	}
+
+	auto mid = std::chrono::steady_clock::now();
+
+	SigScan::ScanAll(image.data(), image.size(), patterns.data(), patterns.size());
+
+	auto end = std::chrono::steady_clock::now();
+
+	/* Warm start, fingerprints of the resolved addresses are compared. */
+	std::vector<SigPattern_t> fingerprints(4);
+	for (size_t p = 0; p < patterns.size(); p++)
+	{
+		fingerprints[p].Set(patterns[p].Result, 16);
+	}
+
+	auto warmStart = std::chrono::steady_clock::now();
+
+	uint32_t verified = 0;
+	for (uint32_t round = 0; round < 1000; round++)
+	{
+		for (size_t p = 0; p < patterns.size(); p++)
+		{
+			verified += fingerprints[p].MatchesAt(patterns[p].Result);
+		}
+	}
+
+	auto warmEnd = std::chrono::steady_clock::now();
+
+	std::printf("cold, one pass per pattern: %8.2f ms\n", std::chrono::duration<double, std::milli>(mid - start).count());
+	std::printf("cold, single pass:          %8.2f ms\n", std::chrono::duration<double, std::milli>(end - mid).count());
+	std::printf("warm, verify 4 addresses:   %8.3f us\n", std::chrono::duration<double, std::micro>(warmEnd - warmStart).count() / 1000);
+
+	for (size_t p = 0; p < patterns.size(); p++)
+	{
+		CHECK(patterns[p].Result != nullptr);
+		CHECK(patterns[p].Result == separate[p]);
+	}
+
+	CHECK(verified == 4000);
+
+	return TestResult();
+}
@@ -0,0 +1,119 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Core/SigScan.h"
+#include "Test.h"
+
+/* Multi-pattern scanner against a naive per-pattern search on synthetic byte images. */
+
+static const uint8_t* NaiveFind(const std::vector<uint8_t>& aImage, const SigPattern_t& aPattern)
+{
+	if (aPattern.Bytes.size() > aImage.size()) { return nullptr; }
+
+	for (size_t i = 0; i + aPattern.Bytes.size() <= aImage.size(); i++)
+	{
+		if (aPattern.MatchesAt(aImage.data() + i)) { return aImage.data() + i; }
+	}
+
+	return nullptr;
+}
+
+static void Plant(std::vector<uint8_t>& aImage, size_t aOffset, const SigPattern_t& aPattern)
+{
+	for (size_t i = 0; i < aPattern.Bytes.size(); i++)
+	{
+		if (aPattern.Mask[i]) { aImage[aOffset + i] = aPattern.Bytes[i]; }
+	}
+}
+
+static void TestParse()
+{
+	SigPattern_t pattern;
+
+	CHECK(pattern.Parse("48 8B ?? 05 ? E8"));
+	CHECK(pattern.Bytes.size() == 6);
+	CHECK(pattern.Mask[2] == 0 && pattern.Mask[4] == 0);
+	CHECK(pattern.Bytes[3] == 0x05);
+
+	/* Anchors on the first uncommon fixed byte. */
+	CHECK(pattern.Anchor == 3);
+
+	CHECK(!pattern.Parse("48 8G"));
+	CHECK(!pattern.Parse("?? ??"));
+	CHECK(!pattern.Parse("4"));
+}
+
+static void TestPlanted(const char* const* aPatterns, size_t aCount, uint32_t aSeed)
+{
+	std::mt19937 rng(aSeed);
+
+	std::vector<uint8_t> image(1 << 20);
+	for (uint8_t& byte : image) { byte = (uint8_t)rng(); }
+
+	std::vector<SigPattern_t> patterns(aCount);
+
+	for (size_t p = 0; p < aCount; p++)
+	{
+		CHECK(patterns[p].Parse(aPatterns[p]));
+
+		/* Twice, only the first one counts. Some land at the very start and end. */
+		size_t size = patterns[p].Bytes.size();
+		size_t first = p == 0 ? 0 : p == 1 ? image.size() - size : rng() % (image.size() - size);
+		Plant(image, first, patterns[p]);
+		Plant(image, rng() % (image.size() - size), patterns[p]);
+	}
+
+	std::vector<const uint8_t*> expected;
+	for (const SigPattern_t& pattern : patterns)
+	{
+		expected.push_back(NaiveFind(image, pattern));
+	}
+
+	size_t resolved = SigScan::ScanAll(image.data(), image.size(), patterns.data(), patterns.size());
+
+	CHECK(resolved == aCount);
+
+	for (size_t p = 0; p < aCount; p++)
+	{
+		CHECK(patterns[p].Result == expected[p]);
+	}
+
+	/* Resolved patterns are skipped on a second pass. */
+	CHECK(SigScan::ScanAll(image.data(), image.size(), patterns.data(), patterns.size()) == 0);
+}
+
+static void TestMissing()
+{
+	std::vector<uint8_t> image(4096, 0xCC);
+
+	SigPattern_t patterns[2];
+	patterns[0].Parse("CC CC 11 22");
+	patterns[1].Parse("CC CC CC");
+
+	CHECK(SigScan::ScanAll(image.data(), image.size(), patterns, 2) == 1);
+	CHECK(patterns[0].Result == nullptr);
+	CHECK(patterns[1].Result == image.data());
+
+	/* Longer than the image. */
+	SigPattern_t tooLong;
+	tooLong.Parse("CC CC CC CC CC");
+	CHECK(SigScan::ScanAll(image.data(), 4, &tooLong, 1) == 0);
+}
+
+int main()
+{
+	TestParse();
+
+	/* Few anchors take the vector path. */
+	static const char* const s_Few[] = { "40 53 48 83 EC 20 ?? 8B D9", "E8 ?? ?? ?? ?? 48 8B 5C 24 30", "48 8D 0D ?? ?? ?? ?? E8 ?? ?? ?? ?? 84 C0", "41 B8 ?? 00 00 00 BA" };
+	TestPlanted(s_Few, 4, 1);
+
+	/* More distinct anchors than the vector path handles. */
+	static const char* const s_Many[] = { "10 20", "11 21 ??", "12 ?? 22", "13 23 33", "14 24", "15 25", "16 26", "17 27", "18 28", "19 29 ?? 39" };
+	TestPlanted(s_Many, 10, 2);
+
+	TestMissing();
+
+	return TestResult();
+}
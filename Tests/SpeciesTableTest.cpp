@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Core/SpeciesTable.h"
+#include "Test.h"
+
+/* Epoch and reader slot scheme of the species table. The test stands in for the watcher
+ * thread and swaps tables as fast as it can, while more ingest threads than reader slots
+ * resolve the species of a synthetic event stream like TrackAgent does.
+ * Every entry of a table is stamped with its generation in TimeGap. A table freed under a
+ * pinned reader is reused by the allocator for the next table and shows a changed stamp. */
+
+#define PUBLISH_COUNT 20000
+#define INGEST_COUNT  12 // More than SPECIESTABLE_READERS, pinning has to wait for a slot.
+#define PROBE_SPECIES 15438
+
+namespace SpeciesTable
+{
+	/* Internal to SpeciesTable.cpp, only the watcher thread calls them. */
+	void Publish(const SpeciesTable_t* aTable);
+	void Reclaim();
+}
+
+static const SpeciesTable_t* MakeTable(uint32_t aGeneration)
+{
+	SpeciesTable_t* table = new SpeciesTable_t();
+	table->Entries.assign(std::begin(Species::Table), std::end(Species::Table));
+
+	std::sort(table->Entries.begin(), table->Entries.end(), [](const SpeciesInfo_t& aLHS, const SpeciesInfo_t& aRHS) {
+		return aLHS.ID < aRHS.ID;
+	});
+
+	for (SpeciesInfo_t& info : table->Entries)
+	{
+		info.Phases.TimeGap = aGeneration;
+
+		/* The probe flips its role every generation, a stale or torn entry disagrees with its stamp. */
+		if (info.ID == PROBE_SPECIES)
+		{
+			info.Role = aGeneration & 1 ? ESpeciesRole::Secondary : ESpeciesRole::Primary;
+		}
+	}
+
+	return table;
+}
+
+int main()
+{
+	std::atomic<bool>     isDone = false;
+	std::atomic<uint32_t> pinned = 0;
+	std::atomic<uint32_t> errors = 0;
+
+	SpeciesTable::Publish(MakeTable(1));
+
+	std::vector<std::thread> ingest;
+
+	for (uint32_t t = 0; t < INGEST_COUNT; t++)
+	{
+		ingest.emplace_back([&, t]
+		{
+			std::mt19937 rng(t);
+			uint32_t lastGeneration = 0;
+
+			while (!isDone.load())
+			{
+				SpeciesTable::Reader_t reader;
+				pinned++;
+
+				if (!reader.Table) { errors++; continue; }
+
+				uint32_t generation = reader.Table->Entries.front().Phases.TimeGap;
+
+				/* Readers pin after the previous one was released, the table only moves forward. */
+				if (generation < lastGeneration) { errors++; }
+				lastGeneration = generation;
+
+				/* A burst of events, each resolving its agent's species. */
+				uint32_t events = 1 + rng() % 64;
+
+				for (uint32_t i = 0; i < events; i++)
+				{
+					uint32_t speciesID = i % 4 == 0 ? PROBE_SPECIES : Species::Table[rng() % Species::Count].ID;
+					const SpeciesInfo_t* info = reader.Find(speciesID);
+
+					if (!info || info->ID != speciesID || info->Phases.TimeGap != generation) { errors++; continue; }
+
+					bool isPrimary = info->Role == ESpeciesRole::Primary;
+
+					if (speciesID == PROBE_SPECIES && isPrimary != !(generation & 1)) { errors++; }
+				}
+
+				/* Still the same table at the end of the burst. */
+				if (reader.Table->Entries.back().Phases.TimeGap != generation) { errors++; }
+			}
+		});
+	}
+
+	for (uint32_t generation = 2; generation <= PUBLISH_COUNT; generation++)
+	{
+		SpeciesTable::Publish(MakeTable(generation));
+
+		if (generation % 64 == 0) { std::this_thread::yield(); }
+	}
+
+	isDone.store(true);
+
+	for (std::thread& thread : ingest)
+	{
+		thread.join();
+	}
+
+	std::printf("%u tables published, %u readers pinned\n", PUBLISH_COUNT, pinned.load());
+
+	CHECK(errors.load() == 0);
+	CHECK(pinned.load() > INGEST_COUNT);
+
+	/* Hangs if a retired table is never reclaimed, frees the last one. */
+	SpeciesTable::Destroy();
+
+	{
+		SpeciesTable::Reader_t reader;
+		CHECK(reader.Table == nullptr);
+		CHECK(reader.Find(PROBE_SPECIES) == nullptr);
+	}
+
+	return TestResult();
+}
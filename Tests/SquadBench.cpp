@@ -0,0 +1,188 @@
+/* Squad attribution over a synthetic 50 player stream.
+ * Every player has two pets and a nested summon, gadgets stay unowned.
+ * Prints ns per event, checks the totals against a per-event reference. */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Test.h"
+
+/* Defines max() like windows.h, include after the standard headers. */
+#include "Core/Combat/CbtEncounter.h"
+
+#define PLAYER_COUNT    50
+#define TARGET_COUNT    10
+#define GADGET_COUNT    5
+#define EVENT_COUNT     2000000
+#define EVENT_SPACING   0.25 // ms, 4000 events per second
+#define PUBLISH_INTERVAL 500
+
+int main()
+{
+	Encounter_t encounter;
+
+	std::vector<Agent_t*> players;
+	std::vector<Agent_t*> sources;
+	std::vector<Agent_t*> targets;
+	std::vector<Agent_t*> gadgets;
+	std::vector<uint32_t> player;  // Expected root player per source, indexed like sources.
+
+	uint32_t id = 1000;
+
+	for (uint32_t i = 0; i < PLAYER_COUNT; i++)
+	{
+		Agent_t* agent = encounter.AddAgent(id++, nullptr);
+		agent->Type     = EAgentType::Character;
+		agent->IsPlayer = true;
+		players.push_back(agent);
+
+		sources.push_back(agent);
+		player.push_back(i);
+
+		for (uint32_t pet = 0; pet < 2; pet++)
+		{
+			Agent_t* minion = encounter.AddAgent(id++, nullptr);
+			encounter.SetOwner(minion, agent);
+			sources.push_back(minion);
+			player.push_back(i);
+
+			if (pet == 0)
+			{
+				Agent_t* nested = encounter.AddAgent(id++, nullptr);
+				encounter.SetOwner(nested, minion);
+				sources.push_back(nested);
+				player.push_back(i);
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < TARGET_COUNT; i++)
+	{
+		Agent_t* agent = encounter.AddAgent(id++, nullptr);
+		agent->IsTarget = i == 0;
+		targets.push_back(agent);
+	}
+
+	for (uint32_t i = 0; i < GADGET_COUNT; i++)
+	{
+		Agent_t* agent = encounter.AddAgent(id++, nullptr);
+		agent->Type = EAgentType::Gadget;
+		gadgets.push_back(agent);
+	}
+
+	encounter.Self = players[0];
+
+	std::mt19937 rng(50);
+	std::vector<CombatEvent_t> events(EVENT_COUNT);
+	std::vector<Stats_t>       deltas(EVENT_COUNT);
+	std::vector<double>        expectedOut(PLAYER_COUNT);
+	std::vector<double>        expectedIn(PLAYER_COUNT);
+	double                     expectedTarget = 0;
+	double                     gadgetOut      = 0;
+
+	for (size_t i = 0; i < EVENT_COUNT; i++)
+	{
+		CombatEvent_t& ev = events[i];
+		ev = {};
+		ev.Time = (uint64_t)(i * EVENT_SPACING);
+
+		float value = (float)(1 + rng() % 5000);
+
+		switch (rng() % 10)
+		{
+			/* Gadgets hit targets but belong to nobody. */
+			case 0:
+				ev.SrcAgent = gadgets[rng() % GADGET_COUNT];
+				ev.DstAgent = targets[rng() % TARGET_COUNT];
+				deltas[i].Damage = -value;
+				gadgetOut -= value;
+				break;
+
+			/* Targets hit players and their minions. */
+			case 1:
+			{
+				size_t src = rng() % sources.size();
+				ev.SrcAgent = targets[rng() % TARGET_COUNT];
+				ev.DstAgent = sources[src];
+				deltas[i].Damage = -value;
+				expectedIn[player[src]] -= value;
+				break;
+			}
+
+			default:
+			{
+				size_t src = rng() % sources.size();
+				ev.SrcAgent = sources[src];
+				ev.DstAgent = targets[rng() % TARGET_COUNT];
+				deltas[i].Damage = -value;
+				expectedOut[player[src]] -= value;
+
+				if (ev.DstAgent->IsTarget) { expectedTarget -= value; }
+				break;
+			}
+		}
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (size_t i = 0; i < EVENT_COUNT; i++)
+	{
+		encounter.AccumulateSquad(events[i], deltas[i], PUBLISH_INTERVAL);
+	}
+
+	encounter.PublishSquad(events.back().Time);
+
+	auto end = std::chrono::steady_clock::now();
+
+	double ns = std::chrono::duration<double, std::nano>(end - start).count() / EVENT_COUNT;
+	std::printf("%d players, %d events: %.2f ns/event\n", PLAYER_COUNT, EVENT_COUNT, ns);
+
+	std::shared_ptr<const std::vector<SquadMember_t>> squad = std::atomic_load(&encounter.Squad);
+
+	CHECK(squad && squad->size() == PLAYER_COUNT);
+
+	/* Float sums drift with the order of additions, compare relatively. */
+	auto near = [](double aLeft, double aRight)
+	{
+		return std::abs(aLeft - aRight) <= std::abs(aRight) * 1e-3 + 1.0;
+	};
+
+	double actualTarget = 0;
+
+	for (const SquadMember_t& member : *squad)
+	{
+		uint32_t idx = (uint32_t)(std::find(players.begin(), players.end(), member.Agent) - players.begin());
+
+		CHECK(idx < PLAYER_COUNT);
+		if (idx >= PLAYER_COUNT) { continue; }
+
+		CHECK(near(member.Stats.OutCleave.Damage, expectedOut[idx]));
+		CHECK(near(member.Stats.InCleave.Damage, expectedIn[idx]));
+
+		actualTarget += member.Stats.OutTarget.Damage;
+	}
+
+	CHECK(near(actualTarget, expectedTarget));
+
+	/* Unowned gadgets keep their damage, nothing is credited to self. */
+	double actualGadget = 0;
+	for (Agent_t* gadget : gadgets)
+	{
+		CHECK(gadget->RootIndex == gadget->Index);
+		actualGadget += encounter.AgentStats[gadget->Index].OutCleave.Damage;
+	}
+
+	CHECK(near(actualGadget, gadgetOut));
+
+	/* Re-rooting a master moves its nested summon along. */
+	Agent_t* pet    = sources[1];
+	Agent_t* nested = sources[2];
+	encounter.SetOwner(pet, players[1]);
+	CHECK(nested->RootIndex == players[1]->Index);
+	CHECK(players[0]->Children == 1 && players[1]->Children == 3);
+
+	return TestResult();
+}
@@ -0,0 +1,73 @@
+/* Downs, deaths and the rallies and revives inferred from combat events. */
+#include <cstdint>
+
+#include "Test.h"
+
+/* Defines max() like windows.h, include after the standard headers. */
+#include "Core/Combat/CbtEncounter.h"
+
+static CombatEvent_t Event(ECombatEventType aType, Agent_t* aSrc, Agent_t* aDst, Skill_t* aSkill, float aValue, bool aIsCondition = false)
+{
+	CombatEvent_t event{};
+	event.Type              = aType;
+	event.SrcAgent          = aSrc;
+	event.DstAgent          = aDst;
+	event.Skill             = aSkill;
+	event.Value             = aValue;
+	event.IsConditionDamage = aIsCondition;
+	return event;
+}
+
+int main()
+{
+	Encounter_t encounter;
+
+	Agent_t* player = encounter.AddAgent(1, nullptr);
+	Agent_t* boss   = encounter.AddAgent(2, nullptr);
+	Agent_t* healer = encounter.AddAgent(3, nullptr);
+
+	Skill_t weapon{};
+	weapon.ID = 10;
+	Skill_t downed{};
+	downed.ID = 11;
+	Skill_t burning{};
+	burning.ID = 12;
+	Skill_t regeneration{};
+	regeneration.ID = 13;
+	regeneration.IsBuff = true;
+	Skill_t heal{};
+	heal.ID = 14;
+
+	/* Cast alive before going down. */
+	encounter.TrackStates(Event(ECombatEventType::Health, player, boss, &weapon, -100.f), 500);
+	encounter.TrackStates(Event(ECombatEventType::Down, boss, player, nullptr, 0.f), 1000);
+
+	/* Downed skills, condition and boon ticks do not rally. */
+	encounter.TrackStates(Event(ECombatEventType::Health, player, boss, &downed, -50.f), 2000);
+	encounter.TrackStates(Event(ECombatEventType::Health, player, boss, &burning, -50.f, true), 3000);
+	encounter.TrackStates(Event(ECombatEventType::Health, player, player, &regeneration, 80.f), 4000);
+	CHECK(player->States.Current() == EAgentState::Downed);
+	CHECK(!downed.IsUsedAlive);
+
+	/* Casting a skill used alive rallies. */
+	encounter.TrackStates(Event(ECombatEventType::Health, player, boss, &weapon, -100.f), 11000);
+	CHECK(player->States.Current() == EAgentState::Alive);
+	CHECK(player->States.TimeIn(EAgentState::Downed, 0, 60000) == 10000);
+
+	/* Healed directly while downed. */
+	encounter.TrackStates(Event(ECombatEventType::Down, boss, player, nullptr, 0.f), 20000);
+	encounter.TrackStates(Event(ECombatEventType::Health, healer, player, &heal, 500.f), 25000);
+	CHECK(player->States.Current() == EAgentState::Alive);
+	CHECK(player->States.TimeIn(EAgentState::Downed, 0, 60000) == 15000);
+
+	/* Condition ticks after death do not revive, a direct cast does. */
+	encounter.TrackStates(Event(ECombatEventType::Death, boss, player, nullptr, 0.f), 30000);
+	encounter.TrackStates(Event(ECombatEventType::Health, player, boss, &burning, -50.f, true), 31000);
+	CHECK(player->States.Current() == EAgentState::Dead);
+
+	encounter.TrackStates(Event(ECombatEventType::Health, player, boss, &downed, -50.f), 40000);
+	CHECK(player->States.Current() == EAgentState::Alive);
+	CHECK(player->States.TimeIn(EAgentState::Dead, 0, 60000) == 10000);
+
+	return TestResult();
+}
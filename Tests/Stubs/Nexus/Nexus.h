@@ -0,0 +1,22 @@
+#pragma once
+
+/* Stand-in for the parts of the Nexus API the tested sources use. */
+#ifndef _MSC_VER
+#define __declspec(aAttribute)
+#endif
+
+enum ELogLevel
+{
+	LOGL_CRITICAL = 1,
+	LOGL_WARNING,
+	LOGL_INFO,
+	LOGL_DEBUG
+};
+
+struct AddonDefinition_t;
+
+struct AddonAPI_t
+{
+	void        (*Log)(ELogLevel aLogLevel, const char* aChannel, const char* aStr);
+	const char* (*Paths_GetAddonDirectory)(const char* aName);
+};
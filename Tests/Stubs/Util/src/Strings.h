@@ -0,0 +1,26 @@
+#pragma once
+
+/* Stand-in for the parts of the Util submodule the tested headers use. */
+#include <cstdio>
+#include <ctime>
+#include <string>
+
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+inline int localtime_s(tm* aResult, const time_t* aTime)
+{
+	return localtime_r(aTime, aResult) ? 0 : 1;
+}
+
+namespace String
+{
+	template<typename... Args>
+	inline std::string Format(const char* aFmt, Args... aArgs)
+	{
+		char buffer[1024];
+		std::snprintf(buffer, sizeof(buffer), aFmt, aArgs...);
+		return buffer;
+	}
+}
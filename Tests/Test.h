@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdio>
+
+/* Minimal checks for the test executables, a failed check does not abort the test. */
+static int s_Failures = 0;
+
+#define CHECK(aExpr) \
+	do \
+	{ \
+		if (!(aExpr)) \
+		{ \
+			std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #aExpr); \
+			s_Failures++; \
+		} \
+	} while (0)
+
+/* Exit code of the test executable. */
+inline int TestResult()
+{
+	if (s_Failures)
+	{
+		std::printf("%d check(s) failed\n", s_Failures);
+		return 1;
+	}
+
+	std::printf("passed\n");
+	return 0;
+}
@@ -0,0 +1,252 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Core/Combat/CbtEventLog.h"
+#include "Core/Combat/CbtMetrics.h"
+#include "Core/Combat/CbtTimeIndex.h"
+#include "Test.h"
+
+/* Time index window queries against a per event reference, with and without spilled chunks. */
+
+struct Reference_t
+{
+	uint32_t Time; // Clamped like the index.
+	double   Damage;
+};
+
+static double ReferenceQuery(const std::vector<Reference_t>& aHits, uint32_t aStart, uint32_t aEnd)
+{
+	double sum = 0;
+
+	for (const Reference_t& hit : aHits)
+	{
+		if (hit.Time >= aStart && hit.Time <= aEnd) { sum += hit.Damage; }
+	}
+
+	return sum;
+}
+
+static void TestWindows(bool aSpill)
+{
+	EventLog_t log;
+	log.SpillEnabled = aSpill;
+	log.SpillPath    = aSpill ? EventSpill::GetSpillPath() : std::string();
+
+	const uint64_t timeStart = 5000000;
+
+	TimeIndex_t target{};
+	TimeIndex_t cleave{};
+	target.Bind(TIMEINDEX_CHANNEL_OUTTARGET);
+	cleave.Bind(TIMEINDEX_CHANNEL_OUTCLEAVE);
+
+	std::vector<Reference_t> refTarget;
+	std::vector<Reference_t> refCleave;
+
+	std::mt19937 rng(36);
+	uint32_t     time   = 0;
+	uint32_t     latest = 0;
+
+	for (int i = 0; i < 30000; i++)
+	{
+		/* Mostly forward, sometimes a few ms back like out of order arrivals. */
+		time += rng() % 4;
+		uint32_t jittered = time > 3 && rng() % 10 == 0 ? time - rng() % 4 : time;
+
+		CombatEvent_t event{};
+		event.Type  = ECombatEventType::Health;
+		event.Time  = timeStart + jittered;
+		event.Value = -(float)(1 + rng() % 1000);
+
+		CombatEvent_t* ev    = log.Append(event);
+		Stats_t        delta = ClassifyEvent(*ev);
+
+		/* Every event is cleave, some are also target, some are neither (not outgoing). */
+		if (rng() % 5 == 0) { continue; }
+
+		latest = jittered > latest ? jittered : latest;
+
+		cleave.Add(*ev, jittered, delta);
+		refCleave.push_back(Reference_t{ latest, delta.Damage });
+
+		if (rng() % 2)
+		{
+			target.Add(*ev, jittered, delta);
+			refTarget.push_back(Reference_t{ refTarget.empty() || jittered > refTarget.back().Time ? jittered : refTarget.back().Time, delta.Damage });
+		}
+	}
+
+	target.Finalize(time);
+	cleave.Finalize(time);
+
+	if (aSpill)
+	{
+		/* Give the writer time to spill the full chunks. */
+		for (int i = 0; i < 100; i++)
+		{
+			{
+				const std::lock_guard<std::mutex> lock(log.Mutex);
+				if (log.PendingWrites == 0 && log.Chunks.front()->IsSpilled) { break; }
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+
+		CHECK(log.Chunks.front()->IsSpilled);
+	}
+
+	for (int i = 0; i < 500; i++)
+	{
+		uint32_t a = rng() % (time + 10);
+		uint32_t b = a + rng() % 5000;
+
+		/* Damages are integers, double sums are exact. */
+		CHECK(target.Query(a, b).Damage == (float)ReferenceQuery(refTarget, a, b));
+		CHECK(cleave.Query(a, b).Damage == (float)ReferenceQuery(refCleave, a, b));
+
+		/* Cached bounds answer the same. */
+		CHECK(target.Query(a, b).Damage == (float)ReferenceQuery(refTarget, a, b));
+	}
+
+	CHECK(target.Query(0, UINT32_MAX).Damage == (float)ReferenceQuery(refTarget, 0, UINT32_MAX));
+	CHECK(target.Query(1000, 999).Damage == 0.f);
+}
+
+/* Readers walk the log while the ingest appends, readers only see complete events in order. */
+static void TestConcurrentReaders()
+{
+	EventLog_t log;
+	log.SpillEnabled = true;
+	log.SpillPath    = EventSpill::GetSpillPath();
+
+	const uint32_t     count = EVENTLOG_CHUNK_SIZE * 40;
+	std::atomic<bool>  isDone{ false };
+	std::atomic<int>   failures{ 0 };
+
+	std::thread writer([&]()
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			CombatEvent_t event{};
+			event.Time  = i;
+			event.Value = (float)i;
+			log.Append(event);
+		}
+
+		isDone = true;
+	});
+
+	std::vector<std::thread> readers;
+	for (int r = 0; r < 3; r++)
+	{
+		readers.emplace_back([&, r]()
+		{
+			while (!isDone)
+			{
+				size_t first = (size_t)r * EVENTLOG_CHUNK_SIZE / 3;
+				size_t next  = first;
+
+				log.ForEachFrom(first, SIZE_MAX, [&](const CombatEvent_t& aEvent)
+				{
+					if (aEvent.Time != next || aEvent.Value != (float)next) { failures++; }
+					next++;
+					return true;
+				});
+			}
+		});
+	}
+
+	writer.join();
+	for (std::thread& reader : readers) { reader.join(); }
+
+	CHECK(failures == 0);
+
+	size_t visited = 0;
+	log.ForEach([&visited](const CombatEvent_t& aEvent)
+	{
+		if (aEvent.Time == visited) { visited++; }
+	});
+
+	CHECK(visited == count);
+}
+
+/* Clearing never waits for the writer, the spill file goes away once the pending writes are done. */
+static void TestClearWithPendingWrites()
+{
+	std::string path;
+
+	{
+		EventLog_t log;
+		log.SpillEnabled = true;
+		log.SpillPath    = EventSpill::GetSpillPath();
+		path = log.SpillPath;
+
+		for (uint32_t i = 0; i < EVENTLOG_CHUNK_SIZE * 64; i++)
+		{
+			CombatEvent_t event{};
+			event.Time = i;
+			log.Append(event);
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		log.Clear();
+		double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		std::printf("cleared with writes pending in %.3f ms\n", elapsed);
+
+		CHECK(log.Size() == 0);
+		CHECK(log.GetResidentBytes() < 1024);
+	}
+
+	for (int i = 0; i < 200 && std::filesystem::exists(path); i++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	CHECK(!std::filesystem::exists(path));
+}
+
+/* A short encounter does not hold a full chunk. */
+static void TestSmallLog()
+{
+	EventLog_t log;
+
+	for (uint32_t i = 0; i < 3; i++)
+	{
+		CombatEvent_t event{};
+		event.Time = i;
+		log.Append(event);
+	}
+
+	CHECK(log.GetResidentBytes() < EVENTLOG_CHUNK_MIN * sizeof(CombatEvent_t) + 256);
+
+	size_t visited = 0;
+	log.ForEach([&visited](const CombatEvent_t& aEvent)
+	{
+		if (aEvent.Time == visited) { visited++; }
+	});
+
+	CHECK(visited == 3);
+}
+
+int main()
+{
+	std::filesystem::path spill = std::filesystem::temp_directory_path() / "cmx_timeindex_test";
+	EventSpill::Create(spill.string());
+
+	TestWindows(false);
+	TestWindows(true);
+	TestConcurrentReaders();
+	TestClearWithPendingWrites();
+	TestSmallLog();
+
+	EventSpill::Destroy();
+
+	std::error_code ec;
+	std::filesystem::remove_all(spill, ec);
+
+	return TestResult();
+}
@@ -7,6 +7,11 @@
 
 #include "Combat/Combat.h"
 #include "GW2RE/Util/Validation.h"
+#include "HistoryIndex.h"
+#include "PersonalBest.h"
+#include "Settings.h"
+#include "SigCache.h"
+#include "SpeciesTable.h"
 #include "UI/UiRoot.h"
 
 extern "C" __declspec(dllexport) AddonDefinition_t* GetAddonDef()
@@ -50,6 +55,11 @@ void Addon::Load(AddonAPI_t* aApi)
 		return;
 	}
 
+	Settings::Load(aApi);
+	SigCache::Load(aApi);
+	PersonalBest::Create(aApi);
+	SpeciesTable::Create(aApi);
+	HistoryIndex::Create(aApi);
 	Combat::Create(aApi);
 	UiRoot::Create(aApi);
 }
@@ -57,5 +67,8 @@ void Addon::Load(AddonAPI_t* aApi)
 void Addon::Unload()
 {
 	Combat::Destroy();
+	PersonalBest::Destroy();
+	SpeciesTable::Destroy();
 	UiRoot::Destroy();
+	HistoryIndex::Destroy();
 }
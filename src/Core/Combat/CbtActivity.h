@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#define ACTIVITY_MIN_GAP    1000 // ms, shorter gaps always count as active and are not stored.
+#define ACTIVITY_MAX_SECOND 60   // Largest threshold in whole seconds the live encounter answers.
+
+/* Active time of an encounter. Gaps between outgoing hits above a threshold
+ * are not counted, the gap before the first hit included. Every hit is O(1).
+ * The ingest writes, the UI may read at any time through ActiveTime(). */
+struct ActivityTracker_t
+{
+	/* Sum of closed gaps above i + 1 seconds per i, a seqlock keeps them consistent with LastHit. */
+	std::atomic<uint32_t> IdleAbove[ACTIVITY_MAX_SECOND] = {};
+	std::atomic<uint32_t> LastHit{ 0 };          // ms relative to encounter start
+	std::atomic<uint32_t> Sequence{ 0 };         // Odd while a gap is being closed.
+
+	std::vector<uint32_t> Gaps;                  // Closed gaps of at least ACTIVITY_MIN_GAP, ingest only until finalized.
+	std::vector<uint64_t> GapSums;               // GapSums[i] is the sum of Gaps[i..], built on finalize.
+	std::atomic<bool>     IsFinalized{ false };  // Released once Gaps is sorted, readers acquire before touching it.
+
+	/* Ingest only. */
+	inline void OnHit(uint32_t aTime)
+	{
+		uint32_t lastHit = this->LastHit.load(std::memory_order_relaxed);
+
+		if (aTime <= lastHit) { return; }
+
+		uint32_t gap = aTime - lastHit;
+
+		/* Short gaps change no sum, readers see either hit time and stay consistent. */
+		if (gap < ACTIVITY_MIN_GAP)
+		{
+			this->LastHit.store(aTime, std::memory_order_relaxed);
+			return;
+		}
+
+		this->Gaps.push_back(gap);
+
+		uint32_t seq = this->Sequence.load(std::memory_order_relaxed);
+
+		this->Sequence.store(seq + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		for (uint32_t i = 0; i < ACTIVITY_MAX_SECOND && gap > (i + 1) * 1000; i++)
+		{
+			this->IdleAbove[i].store(this->IdleAbove[i].load(std::memory_order_relaxed) + gap, std::memory_order_relaxed);
+		}
+
+		this->LastHit.store(aTime, std::memory_order_relaxed);
+
+		this->Sequence.store(seq + 2, std::memory_order_release);
+	}
+
+	/* Active time for any threshold. Finalized it is exact from the stored gaps in O(log n),
+	 * live the threshold is rounded down to whole seconds up to ACTIVITY_MAX_SECOND. */
+	inline uint32_t ActiveTime(uint32_t aDuration, uint32_t aThreshold) const
+	{
+		aThreshold = aThreshold < ACTIVITY_MIN_GAP ? ACTIVITY_MIN_GAP : aThreshold;
+
+		uint64_t idle     = 0;
+		uint32_t lastHit  = 0;
+
+		if (this->IsFinalized.load(std::memory_order_acquire))
+		{
+			size_t first = std::upper_bound(this->Gaps.begin(), this->Gaps.end(), aThreshold) - this->Gaps.begin();
+
+			idle    = this->GapSums.empty() ? 0 : this->GapSums[first];
+			lastHit = this->LastHit.load(std::memory_order_relaxed);
+		}
+		else
+		{
+			uint32_t second = std::min<uint32_t>(aThreshold / 1000, ACTIVITY_MAX_SECOND);
+			aThreshold = second * 1000;
+
+			for (;;)
+			{
+				uint32_t seq = this->Sequence.load(std::memory_order_acquire);
+
+				if (seq & 1) { continue; }
+
+				idle    = this->IdleAbove[second - 1].load(std::memory_order_relaxed);
+				lastHit = this->LastHit.load(std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_acquire);
+
+				if (this->Sequence.load(std::memory_order_relaxed) == seq) { break; }
+			}
+		}
+
+		uint32_t trailing = aDuration > lastHit ? aDuration - lastHit : 0;
+		idle += trailing > aThreshold ? trailing : 0;
+
+		return aDuration > idle ? (uint32_t)(aDuration - idle) : 0;
+	}
+
+	/* Ingest only, once after the last hit. */
+	inline void Finalize()
+	{
+		if (this->IsFinalized.load(std::memory_order_relaxed)) { return; }
+
+		std::sort(this->Gaps.begin(), this->Gaps.end());
+
+		this->GapSums.resize(this->Gaps.size() + 1);
+		this->GapSums[this->Gaps.size()] = 0;
+
+		for (size_t i = this->Gaps.size(); i > 0; i--)
+		{
+			this->GapSums[i - 1] = this->GapSums[i] + this->Gaps[i - 1];
+		}
+
+		this->IsFinalized.store(true, std::memory_order_release);
+	}
+};
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <cstdint>
-#include <string>
+
+#include "CbtStateTimeline.h"
+#include "Core/Format.h"
 
 enum class EAgentType
 {
@@ -17,26 +19,44 @@ struct Agent_t
 	EAgentType  Type;
 	char        Name[128];
 
+	bool        IsPlayer;
+	bool        IsTarget;   // Species is a primary or secondary target.
+	bool        IsPrimary;  // Species starts an encounter.
 	bool        IsMinion;
-	uint32_t    OwnerID;
+	uint32_t    OwnerID;    // ID of the direct master, 0 if not owned.
+	uint64_t    OwnerCheck; // Tick the master was last read from the game.
+
+	/* Ownership graph, indices into Encounter_t::AgentList. */
+	uint32_t    Index;      // Position of this agent.
+	uint32_t    OwnerIndex; // Direct master, own index if not owned.
+	uint32_t    RootIndex;  // Top-most master, own index if not owned.
+	uint32_t    Children;   // Number of agents this is the direct master of.
+
+	const void* GameAgent;  // Game agent this was tracked from, detects recycled IDs.
+
+	StateTimeline_t States; // Downs and deaths, built at ingest.
 
-	inline std::string GetName()
+	/* Name without allocating, the fallback is written into the buffer. */
+	inline const char* GetName(char* aBuffer, size_t aSize) const
 	{
 		if (this->Name[0])
 		{
 			return this->Name;
 		}
 
+		const char* prefix = "ag-";
+
 		switch (this->Type)
 		{
-			default:
-				return "ag-" + std::to_string(this->ID);
-			case EAgentType::Character:
-				return "ch-" + std::to_string(this->ID);
-			case EAgentType::Gadget:
-				return "gd-" + std::to_string(this->ID);
-			case EAgentType::AttackTarget:
-				return "at-" + std::to_string(this->ID);
+			case EAgentType::Character:    prefix = "ch-"; break;
+			case EAgentType::Gadget:       prefix = "gd-"; break;
+			case EAgentType::AttackTarget: prefix = "at-"; break;
 		}
+
+		size_t length = 0;
+		aBuffer[0] = '\0';
+
+		Format::Append(aBuffer, aSize, length, prefix);
+		return Format::AppendInteger(aBuffer, aSize, length, this->ID);
 	}
 };
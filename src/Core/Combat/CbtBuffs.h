@@ -0,0 +1,215 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "CbtSkill.h"
+
+/* Time in ms a removal may arrive after the expiry it reports. */
+#define BUFFS_REMOVE_SLACK 100
+
+enum class EBuffStacking : uint8_t
+{
+	Intensity, // Stacks run side by side, each one counts.
+	Duration   // Stacks queue up, one runs at a time.
+};
+
+namespace Buffs
+{
+	/* Boons and conditions stacking in duration, everything else stacks in intensity. */
+	inline constexpr uint32_t DurationStacking[] = {
+		717,   // Protection
+		718,   // Regeneration
+		719,   // Swiftness
+		720,   // Blinded
+		721,   // Crippled
+		722,   // Chilled
+		725,   // Fury
+		726,   // Vigor
+		727,   // Immobile
+		742,   // Weakness
+		743,   // Aegis
+		791,   // Fear
+		873,   // Resolution
+		1187,  // Quickness
+		5974,  // Superspeed
+		26766, // Slow
+		26980, // Resistance
+		27705, // Taunt
+		30328  // Alacrity
+	};
+
+	constexpr EBuffStacking GetStacking(uint32_t aBuffID)
+	{
+		for (uint32_t id : DurationStacking)
+		{
+			if (id == aBuffID) { return EBuffStacking::Duration; }
+		}
+
+		return EBuffStacking::Intensity;
+	}
+}
+
+/* Uptime of one buff on one agent. Every stack is tracked by its expiry,
+ * coverage and stack time are integrated between changes. Expiries are kept
+ * in a min-heap bounded by the stack limit of the game, every event is O(1)
+ * amortized. The game reports stacks that ran out with a removal as well,
+ * those removals are matched to the expiries instead of ending another stack. */
+struct BuffUptime_t
+{
+	Skill_t*              Buff       = nullptr;
+	EBuffStacking         Stacking   = EBuffStacking::Intensity;
+	uint32_t              LastChange = 0; // ms relative to encounter start
+	uint64_t              Covered    = 0; // ms with at least one stack.
+	uint64_t              StackTime  = 0; // Integral of the stack count in stack-ms.
+	uint32_t              MaxStacks  = 0;
+
+	std::vector<uint32_t> Expiries;       // Min-heap of stack expiry times, UINT32_MAX until removed.
+	uint32_t              QueueEnd   = 0; // Expiry of the last queued stack, duration stacking only.
+	uint32_t              LastExpiry = 0; // Time the latest stack ran out.
+	uint32_t              Unreported = 0; // Stacks that ran out at LastExpiry and were not removed by the game yet.
+
+	/* Stacks in effect, a duration queue only runs one at a time. */
+	inline uint32_t Stacks() const
+	{
+		uint32_t count = (uint32_t)this->Expiries.size();
+		return this->Stacking == EBuffStacking::Duration && count > 1 ? 1 : count;
+	}
+
+	/* Integrates the current stacks up to the given time. */
+	inline void Step(uint32_t aTime)
+	{
+		if (aTime <= this->LastChange) { return; }
+
+		if (!this->Expiries.empty())
+		{
+			uint32_t span = aTime - this->LastChange;
+
+			this->Covered   += span;
+			this->StackTime += (uint64_t)span * this->Stacks();
+		}
+
+		this->LastChange = aTime;
+	}
+
+	/* Expires stacks that ran out until the given time. */
+	inline void Advance(uint32_t aTime)
+	{
+		while (!this->Expiries.empty() && this->Expiries.front() <= aTime)
+		{
+			uint32_t expiry = this->Expiries.front();
+
+			this->Step(expiry);
+
+			std::pop_heap(this->Expiries.begin(), this->Expiries.end(), std::greater<uint32_t>());
+			this->Expiries.pop_back();
+
+			/* Removals of older expiries never came, they are not waited for anymore. */
+			if (expiry - this->LastExpiry > BUFFS_REMOVE_SLACK) { this->Unreported = 0; }
+
+			this->LastExpiry = expiry;
+			this->Unreported++;
+		}
+
+		this->Step(aTime);
+	}
+
+	/* A duration of 0 keeps the stack until it is removed. */
+	inline void Apply(uint32_t aTime, uint32_t aDuration)
+	{
+		this->Advance(aTime);
+
+		uint32_t expiry = UINT32_MAX;
+
+		if (aDuration && this->Stacking == EBuffStacking::Duration)
+		{
+			/* Queued behind the stacks already running. */
+			uint32_t start = this->Expiries.empty() || this->QueueEnd < aTime ? aTime : this->QueueEnd;
+			expiry = start + aDuration;
+			this->QueueEnd = expiry;
+		}
+		else if (aDuration)
+		{
+			expiry = aTime + aDuration;
+		}
+
+		this->Expiries.push_back(expiry);
+		std::push_heap(this->Expiries.begin(), this->Expiries.end(), std::greater<uint32_t>());
+
+		this->MaxStacks = this->Stacks() > this->MaxStacks ? this->Stacks() : this->MaxStacks;
+	}
+
+	/* Removes the stack closest to expiring. The removal of a stack that just ran out only confirms its expiry. */
+	inline void Remove(uint32_t aTime)
+	{
+		this->Advance(aTime);
+
+		if (this->Unreported && aTime - this->LastExpiry <= BUFFS_REMOVE_SLACK)
+		{
+			this->Unreported--;
+			return;
+		}
+
+		if (this->Expiries.empty()) { return; }
+
+		uint32_t expiry = this->Expiries.front();
+
+		std::pop_heap(this->Expiries.begin(), this->Expiries.end(), std::greater<uint32_t>());
+		this->Expiries.pop_back();
+
+		/* The running stack of a queue ended early, the ones behind it start now. */
+		if (this->Stacking == EBuffStacking::Duration && expiry != UINT32_MAX && expiry > aTime)
+		{
+			uint32_t shift = expiry - aTime;
+
+			for (uint32_t& queued : this->Expiries)
+			{
+				if (queued != UINT32_MAX) { queued -= shift; }
+			}
+
+			this->QueueEnd -= shift;
+		}
+	}
+
+	/* Takes over the stacks aFrom still has at aTime of its timeline, at time 0 of this one.
+	 * Carries buffs over from before an encounter started. */
+	inline void Carry(BuffUptime_t& aFrom, uint32_t aTime)
+	{
+		aFrom.Advance(aTime);
+
+		this->Buff       = aFrom.Buff;
+		this->Stacking   = aFrom.Stacking;
+		this->LastChange = 0;
+		this->QueueEnd   = aFrom.QueueEnd > aTime ? aFrom.QueueEnd - aTime : 0;
+		this->Expiries   = aFrom.Expiries;
+
+		/* A uniform shift keeps the heap order. */
+		for (uint32_t& expiry : this->Expiries)
+		{
+			if (expiry != UINT32_MAX) { expiry -= aTime; }
+		}
+
+		this->MaxStacks = this->Stacks() > this->MaxStacks ? this->Stacks() : this->MaxStacks;
+	}
+
+	/* Closes the open stacks at the end of the encounter. */
+	inline void Finalize(uint32_t aDuration)
+	{
+		this->Advance(aDuration);
+		this->Expiries.clear();
+		this->Expiries.shrink_to_fit();
+	}
+
+	/* Share of the duration with at least one stack, 0..1. */
+	inline float Uptime(uint32_t aDuration) const
+	{
+		return aDuration ? (float)this->Covered / aDuration : 0.f;
+	}
+
+	inline float AverageStacks(uint32_t aDuration) const
+	{
+		return aDuration ? (float)this->StackTime / aDuration : 0.f;
+	}
+};
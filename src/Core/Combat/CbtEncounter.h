@@ -1,21 +1,31 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <memory>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
+#include "CbtActivity.h"
 #include "CbtAgent.h"
+#include "CbtBuffs.h"
 #include "CbtEvent.h"
+#include "CbtEventLog.h"
+#include "CbtMetrics.h"
+#include "CbtPhases.h"
+#include "CbtRecap.h"
+#include "CbtSkill.h"
+#include "CbtSquad.h"
+#include "CbtStats.h"
+#include "CbtTimeIndex.h"
+#include "Core/FlatMap.h"
+#include "Core/Format.h"
+#include "Species.h"
 #include "Util/src/Strings.h"
 
-struct Stats_t
-{
-	float Damage  = 0.f;
-	float Heal    = 0.f;
-	float Barrier = 0.f;
-};
+/* Metrics accumulated per direction and target filter. */
+using EncounterMetrics_t = Metrics_t<Stats_t, HitCount_t, DamageSplit_t, HitRange_t>;
 
 struct Encounter_t
 {
@@ -23,59 +33,335 @@ struct Encounter_t
 	uint64_t                               TimeEnd   = 0;
 
 	uint32_t                               TriggerID = 0;
+	uint32_t                               SpeciesID = 0;     // Species of the trigger.
+	bool                                   IsKill    = false; // Whether the trigger died.
+
+	/* Copied from the species table once the trigger is known, the table may be swapped later. */
+	char                                   SpeciesName[64] = {};    // Fallback until the localized trigger name is decoded.
+	ESpeciesGroup                          Group = ESpeciesGroup::Special;
+	bool                                   IsCM  = false;
+
+	uint64_t                               LastAccess = 0; // tick of the last time the encounter was displayed
+
+	/* GetMemoryUsage() as last sampled by the ingest, final once sealed. The UI only reads this. */
+	std::atomic<size_t>                    MemoryUsage{ 0 };
 
 	Agent_t*                               Self      = 0;
-	Stats_t                                OutTarget = {};
-	Stats_t                                OutCleave = {};
-	Stats_t                                InTarget  = {};
-	Stats_t                                InCleave  = {};
+	EncounterMetrics_t                     OutTarget = {};
+	EncounterMetrics_t                     OutCleave = {};
+	EncounterMetrics_t                     InTarget  = {};
+	EncounterMetrics_t                     InCleave  = {};
+	HitQuantiles_t                         OutHits   = {}; // All outgoing skills merged, built on combat end.
+
+	/* Prefix sums for time window queries, relative to TimeStart. Bound to CombatEvents. */
+	TimeIndex_t                            OutTargetIndex = {};
+	TimeIndex_t                            OutCleaveIndex = {};
+	TimeIndex_t                            InTargetIndex  = {};
+	TimeIndex_t                            InCleaveIndex  = {};
+
+	PhaseTracker_t                         Phases    = {};
+	ActivityTracker_t                      Activity  = {}; // Gaps between outgoing hits.
+
+	/* Squad mode, stats per root agent indexed like AgentList. */
+	std::vector<AgentStats_t>              AgentStats;
+	uint64_t                               SquadPublishTime = 0;
+
+	/* Immutable snapshot of the squad, swapped atomically for the UI. */
+	std::shared_ptr<const std::vector<SquadMember_t>> Squad;
+
+	/* Latest down or death of self, swapped atomically for the UI. */
+	std::shared_ptr<const DeathRecap_t>    Recap;
+
+	FlatMap_t<Agent_t*>                    Agents;    // Currently live agent per ID.
+	std::vector<Agent_t*>                  AgentList; // Every agent ever tracked, owns the agents.
+	FlatMap_t<Skill_t*>                    Skills;
+	FlatMap_t<BuffUptime_t*>               BuffsSelf;   // Per buff ID, owns the entries.
+	FlatMap_t<BuffUptime_t*>               BuffsTarget; // Per buff ID on the trigger, owns the entries.
+	Agent_t*                               FirstTarget = nullptr; // First agent hit by self, names the encounter without a trigger.
+	EventLog_t                             CombatEvents;
+
+	/* Assigns the time indices their channels. */
+	inline void BindTimeIndices()
+	{
+		this->OutTargetIndex.Bind(TIMEINDEX_CHANNEL_OUTTARGET);
+		this->OutCleaveIndex.Bind(TIMEINDEX_CHANNEL_OUTCLEAVE);
+		this->InTargetIndex.Bind(TIMEINDEX_CHANNEL_INTARGET);
+		this->InCleaveIndex.Bind(TIMEINDEX_CHANNEL_INCLEAVE);
+	}
+
+	/* "hh:mm:ss, duration (tag target CM)" written into the buffer. Reads the agent map,
+	 * only call it from the ingest or on a finalized encounter. Returns the buffer. */
+	inline char* GetName(char* aBuffer, size_t aSize) const
+	{
+		char targetBuffer[128];
+		const char* targetName = this->GetTargetName(targetBuffer, sizeof(targetBuffer));
+
+		const char* tag = Species::GetGroupTag(this->Group);
+
+		time_t time = this->TimeStart / 1000; // needs to be in seconds
+		tm tm{};
+		localtime_s(&tm, &time);
+
+		size_t length = 0;
+		aBuffer[0] = '\0';
+
+		const int clock[] = { tm.tm_hour, tm.tm_min, tm.tm_sec };
+
+		for (size_t i = 0; i < 3; i++)
+		{
+			Format::Append(aBuffer, aSize, length, i == 0 ? "" : ":");
+			Format::Append(aBuffer, aSize, length, clock[i] < 10 ? "0" : "");
+			Format::AppendInteger(aBuffer, aSize, length, (uint64_t)clock[i]);
+		}
+
+		char durationStr[32];
+		Format::Append(aBuffer, aSize, length, ", ");
+		Format::Append(aBuffer, aSize, length, this->Duration(durationStr, sizeof(durationStr)));
+		Format::Append(aBuffer, aSize, length, " (");
+		Format::Append(aBuffer, aSize, length, tag);
+		Format::Append(aBuffer, aSize, length, tag[0] ? " " : "");
+		Format::Append(aBuffer, aSize, length, targetName);
+		Format::Append(aBuffer, aSize, length, this->IsCM ? " CM" : "");
+		return Format::Append(aBuffer, aSize, length, ")");
+	}
+
+	/* Localized name of the trigger, the species name while it is still being decoded.
+	 * Reads the agent map like GetName(). */
+	inline const char* GetTargetName(char* aBuffer, size_t aSize) const
+	{
+		Agent_t* trigger = this->Agents.Peek(this->TriggerID);
 
-	std::unordered_map<uint32_t, Agent_t*> Agents;
-	std::unordered_map<uint32_t, Skill_t*> Skills;
-	std::vector<CombatEvent_t*>            CombatEvents;
+		if (trigger && !trigger->Name[0] && this->SpeciesName[0])
+		{
+			return this->SpeciesName;
+		}
+
+		if (Agent_t* agent = trigger ? trigger : this->FirstTarget)
+		{
+			return agent->GetName(aBuffer, aSize);
+		}
+
+		if (aSize) { aBuffer[0] = 0; }
+		return aBuffer;
+	}
 
-	inline std::string GetName()
+	/* Creates a new agent for the ID, replacing a previous agent with a recycled ID. */
+	inline Agent_t* AddAgent(uint32_t aID, const void* aGameAgent)
 	{
-		std::string targetName;
-		if (this->TriggerID)
+		Agent_t* agent = new Agent_t();
+		agent->ID         = aID;
+		agent->Index      = (uint32_t)this->AgentList.size();
+		agent->OwnerIndex = agent->Index;
+		agent->RootIndex  = agent->Index;
+		agent->GameAgent  = aGameAgent;
+
+		this->AgentList.push_back(agent);
+		this->Agents.Set(aID, agent);
+
+		return agent;
+	}
+
+	/* Sets the direct master of an agent and re-roots everything it summoned. */
+	inline void SetOwner(Agent_t* aAgent, Agent_t* aOwner)
+	{
+		/* Refuse cycles. */
+		if (aOwner && aOwner->RootIndex == aAgent->Index) { return; }
+
+		uint32_t ownerIndex = aOwner ? aOwner->Index : aAgent->Index;
+
+		if (ownerIndex != aAgent->OwnerIndex)
 		{
-			targetName = this->Agents.at(TriggerID)->GetName();
+			if (aAgent->OwnerIndex != aAgent->Index) { this->AgentList[aAgent->OwnerIndex]->Children--; }
+			if (aOwner)                              { aOwner->Children++; }
 		}
-		else
+
+		aAgent->IsMinion   = aOwner != nullptr;
+		aAgent->OwnerID    = aOwner ? aOwner->ID : 0;
+		aAgent->OwnerIndex = ownerIndex;
+
+		uint32_t root = aOwner ? aOwner->RootIndex : aAgent->Index;
+
+		if (root == aAgent->RootIndex) { return; }
+
+		aAgent->RootIndex = root;
+
+		/* Nothing to re-root, e.g. a freshly tracked minion. */
+		if (aAgent->Children == 0) { return; }
+
+		/* Masters rarely change, a scan is cheaper than keeping child lists per agent. */
+		for (Agent_t* agent : this->AgentList)
 		{
-			for (CombatEvent_t* ev : this->CombatEvents)
+			if (agent != aAgent && agent->OwnerIndex == aAgent->Index)
 			{
-				if (ev->SrcAgent == this->Self && ev->DstAgent && ev->DstAgent != this->Self)
-				{
-					targetName = ev->DstAgent->GetName();
+				this->SetOwner(agent, aAgent);
+			}
+		}
+	}
+
+	/* True if the agent is self or summoned by self, directly or nested. */
+	inline bool IsOwnedBySelf(const Agent_t* aAgent) const
+	{
+		return aAgent && this->Self && aAgent->RootIndex == this->Self->Index;
+	}
+
+	inline AgentStats_t& GetAgentStats(uint32_t aIndex)
+	{
+		if (aIndex >= this->AgentStats.size())
+		{
+			this->AgentStats.resize(this->AgentList.size());
+		}
+
+		return this->AgentStats[aIndex];
+	}
+
+	/* Squad mode, attributes the event to the roots of source and destination.
+	 * Republishes the squad every aInterval ms of combat time. */
+	inline void AccumulateSquad(const CombatEvent_t& aEvent, const Stats_t& aDelta, uint64_t aInterval)
+	{
+		AgentStats_t& srcStats = this->GetAgentStats(aEvent.SrcAgent->RootIndex);
+		srcStats.OutCleave += aDelta;
+
+		if (aEvent.DstAgent->IsTarget)
+		{
+			srcStats.OutTarget += aDelta;
+		}
+
+		AgentStats_t& dstStats = this->GetAgentStats(aEvent.DstAgent->RootIndex);
+		dstStats.InCleave += aDelta;
+
+		if (aEvent.Time - this->SquadPublishTime >= aInterval)
+		{
+			this->PublishSquad(aEvent.Time);
+		}
+	}
+
+	/* The combat tracker reports no rallies or revives, they are inferred from the event.
+	 * Only direct casts prove an agent is up again, condition and buff ticks keep running
+	 * while downed or dead. A downed agent is up once it is healed directly or casts a
+	 * skill it or anybody else cast while alive, downed skills are never cast alive. */
+	inline void TrackStates(const CombatEvent_t& aEvent, uint32_t aTime)
+	{
+		if (aEvent.Type != ECombatEventType::Health)
+		{
+			if (aEvent.DstAgent)
+			{
+				aEvent.DstAgent->States.Set(aTime, aEvent.Type == ECombatEventType::Down ? EAgentState::Downed : EAgentState::Dead);
+			}
+
+			return;
+		}
+
+		bool isCast = aEvent.Skill && !aEvent.Skill->IsBuff && !aEvent.IsConditionDamage;
+
+		if (!isCast) { return; }
+
+		if (Agent_t* src = aEvent.SrcAgent)
+		{
+			switch (src->States.Current())
+			{
+				case EAgentState::Alive:
+					aEvent.Skill->IsUsedAlive = true;
+					break;
+				case EAgentState::Downed:
+					if (aEvent.Skill->IsUsedAlive) { src->States.Set(aTime, EAgentState::Alive); }
+					break;
+				case EAgentState::Dead:
+					src->States.Set(aTime, EAgentState::Alive);
 					break;
-				}
 			}
 		}
 
-		time_t time = this->TimeStart / 1000; // needs to be in seconds
-		tm tm{};
-		localtime_s(&tm, &time);
+		if (aEvent.DstAgent && aEvent.Value > 0.f && aEvent.DstAgent->States.Current() == EAgentState::Downed)
+		{
+			aEvent.DstAgent->States.Set(aTime, EAgentState::Alive);
+		}
+	}
+
+	/* Publishes the players and their accumulated stats for the UI. */
+	inline void PublishSquad(uint64_t aTime)
+	{
+		auto squad = std::make_shared<std::vector<SquadMember_t>>();
 
-		return String::Format("%02d:%02d:%02d, %s (%s)", tm.tm_hour, tm.tm_min, tm.tm_sec, this->Duration().c_str(), targetName.c_str());
+		for (size_t i = 0; i < this->AgentStats.size(); i++)
+		{
+			Agent_t* agent = this->AgentList[i];
+
+			if (!agent->IsPlayer) { continue; }
+
+			squad->push_back(SquadMember_t{ agent, this->AgentStats[i] });
+		}
+
+		std::atomic_store(&this->Squad, std::shared_ptr<const std::vector<SquadMember_t>>(squad));
+		this->SquadPublishTime = aTime;
 	}
 
-	inline std::string Duration()
+	/* Approximate heap and inline bytes held by the encounter. Only the
+	 * writer may call this while the encounter is live, others read MemoryUsage. */
+	inline size_t GetMemoryUsage() const
 	{
-		uint64_t cbtDurationMs = max(this->TimeEnd - this->TimeStart, 1000);
-		float cbtDuration = cbtDurationMs / 1000.f;
+		size_t bytes = sizeof(Encounter_t);
 
-		std::string durationStr;
+		bytes += this->Agents.Capacity() * sizeof(FlatMap_t<Agent_t*>::Slot_t);
+		bytes += this->AgentList.size() * sizeof(Agent_t);
+		bytes += this->AgentList.capacity() * sizeof(Agent_t*);
 
-		if (cbtDurationMs > 60000)
+		for (const Agent_t* agent : this->AgentList)
 		{
-			durationStr = String::Format("%um%.2fs", cbtDurationMs / 1000 / 60, fmod(cbtDuration, 60.f));
+			bytes += agent->States.Changes.capacity() * sizeof(StateTimeline_t::Change_t);
 		}
-		else
+
+		bytes += this->Skills.Size() * sizeof(Skill_t);
+		bytes += this->Skills.Capacity() * sizeof(FlatMap_t<Skill_t*>::Slot_t);
+		this->Skills.ForEach([&bytes](uint32_t, Skill_t* aSkill)
+		{
+			bytes += aSkill->Out.HitSizes.GetMemoryUsage();
+		});
+		bytes += this->OutHits.HitSizes.GetMemoryUsage();
+
+		for (const FlatMap_t<BuffUptime_t*>* buffs : { &this->BuffsSelf, &this->BuffsTarget })
 		{
-			durationStr = String::Format("%.2fs", cbtDuration);
+			bytes += buffs->Size() * sizeof(BuffUptime_t);
+			bytes += buffs->Capacity() * sizeof(FlatMap_t<BuffUptime_t*>::Slot_t);
+			buffs->ForEach([&bytes](uint32_t, BuffUptime_t* aUptime)
+			{
+				bytes += aUptime->Expiries.capacity() * sizeof(uint32_t);
+			});
 		}
 
-		return durationStr;
+		bytes += this->CombatEvents.GetResidentBytes();
+
+		for (const TimeIndex_t* idx : { &this->OutTargetIndex, &this->OutCleaveIndex, &this->InTargetIndex, &this->InCleaveIndex })
+		{
+			bytes += idx->Samples.capacity() * sizeof(TimeIndex_t::Entry_t);
+			bytes += idx->Points.capacity() * sizeof(TimeIndex_t::Point_t);
+		}
+
+		bytes += this->Phases.Phases.capacity() * sizeof(Phase_t);
+		bytes += this->Activity.Gaps.capacity() * sizeof(uint32_t);
+		bytes += this->Activity.GapSums.capacity() * sizeof(uint64_t);
+
+		bytes += this->AgentStats.capacity() * sizeof(AgentStats_t);
+
+		if (this->Recap)
+		{
+			bytes += sizeof(DeathRecap_t);
+		}
+
+		return bytes;
+	}
+
+	/* Duration in ms without gaps between outgoing hits above the threshold, at least a second. */
+	inline uint64_t ActiveDurationMs(uint32_t aThreshold) const
+	{
+		uint32_t duration = (uint32_t)(this->TimeEnd - this->TimeStart);
+		uint32_t active   = this->Activity.ActiveTime(duration, aThreshold);
+
+		return max(active, 1000);
+	}
+
+	/* Duration written into the buffer, at least a second. Returns the buffer. */
+	inline char* Duration(char* aBuffer, size_t aSize) const
+	{
+		return Format::Duration(aBuffer, aSize, max(this->TimeEnd - this->TimeStart, 1000));
 	}
 };
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <cstdint>
-#include <string>
 
 #include "CbtAgent.h"
 
@@ -12,21 +11,8 @@ enum class ECombatEventType
 	Death
 };
 
-struct Skill_t
-{
-	uint32_t ID;
-	char     Name[128];
-
-	inline std::string GetName()
-	{
-		if (this->Name[0])
-		{
-			return this->Name;
-		}
-
-		return "sk-" + std::to_string(this->ID);
-	}
-};
+/* See CbtSkill.h. */
+struct Skill_t;
 
 struct CombatEvent_t
 {
@@ -44,4 +30,5 @@ struct CombatEvent_t
 	uint32_t         IsConditionDamage : 1;
 	uint32_t         IsCritical        : 1;
 	uint32_t         IsFumble          : 1;
+	uint32_t         Channels          : 4; // Time index channels the event was added to, see CbtTimeIndex.h.
 };
@@ -0,0 +1,190 @@
+#include "CbtEventFeed.h"
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "CbtSkill.h"
+
+namespace EventFeed
+{
+	struct Subscriber_t
+	{
+		uint32_t           Handle;
+		EVENTFEED_CALLBACK Callback;
+		void*              UserData;
+		uint64_t           Cursor;  // Next record to deliver.
+		uint32_t           Dropped; // Lost since the last delivery.
+	};
+
+	static AddonAPI_t*                     s_APIDefs     = nullptr;
+	static EventFeedApi_t*                 s_Api         = nullptr;
+
+	static EventRecord_t                   s_Ring[CMX_EVENTFEED_CAPACITY] = {};
+	static std::atomic<uint64_t>           s_Head        = 0; // Records ever written.
+
+	static std::mutex                      s_Mutex;           // Guards the subscribers.
+	static std::vector<Subscriber_t>       s_Subscribers;
+	static std::atomic<uint32_t>           s_Count       = 0;
+	static uint32_t                        s_NextHandle  = 1;
+	static uint64_t                        s_NamesFrom   = 0; // Records before this lost their names, guarded by s_Mutex.
+
+	static std::vector<EventRecord_t>      s_Batch;           // Only touched by the dispatch.
+
+	uint32_t Subscribe(EVENTFEED_CALLBACK aCallback, void* aUserData);
+	void Unsubscribe(uint32_t aHandle);
+}
+
+static_assert((CMX_EVENTFEED_CAPACITY & (CMX_EVENTFEED_CAPACITY - 1)) == 0, "Capacity must be a power of two.");
+
+void EventFeed::Create(AddonAPI_t* aApi)
+{
+	s_APIDefs = aApi;
+
+	void* shared = s_APIDefs->DataLink_Share(DL_CMX_EVENTFEED, sizeof(EventFeedApi_t));
+
+	if (!shared) { return; }
+
+	s_Api = new (shared) EventFeedApi_t();
+	s_Api->Version     = CMX_EVENTFEED_VERSION;
+	s_Api->Size        = sizeof(EventFeedApi_t);
+	s_Api->Subscribe   = Subscribe;
+	s_Api->Unsubscribe = Unsubscribe;
+}
+
+void EventFeed::Destroy()
+{
+	if (s_Api)
+	{
+		s_Api->Subscribe   = nullptr;
+		s_Api->Unsubscribe = nullptr;
+	}
+
+	const std::lock_guard<std::mutex> lock(s_Mutex);
+	s_Subscribers.clear();
+	s_Count = 0;
+}
+
+bool EventFeed::HasSubscribers()
+{
+	return s_Count.load(std::memory_order_relaxed) > 0;
+}
+
+void EventFeed::Push(const CombatEvent_t& aEvent, uint8_t aFlags)
+{
+	uint64_t head = s_Head.load(std::memory_order_relaxed);
+
+	EventRecord_t& record = s_Ring[head & (CMX_EVENTFEED_CAPACITY - 1)];
+
+	record.Time         = aEvent.Time;
+	record.SrcName      = aEvent.SrcAgent ? aEvent.SrcAgent->Name : nullptr;
+	record.DstName      = aEvent.DstAgent ? aEvent.DstAgent->Name : nullptr;
+	record.SkillName    = aEvent.Skill ? aEvent.Skill->Name : nullptr;
+	record.SrcID        = aEvent.SrcAgent ? aEvent.SrcAgent->ID : 0;
+	record.DstID        = aEvent.DstAgent ? aEvent.DstAgent->ID : 0;
+	record.SrcSpeciesID = aEvent.SrcAgent ? aEvent.SrcAgent->SpeciesID : 0;
+	record.DstSpeciesID = aEvent.DstAgent ? aEvent.DstAgent->SpeciesID : 0;
+	record.SkillID      = aEvent.Skill ? aEvent.Skill->ID : 0;
+	record.Value        = aEvent.Value;
+	record.ValueAlt     = aEvent.ValueAlt;
+	record.Type         = (uint8_t)aEvent.Type;
+	record.Flags        = aFlags;
+
+	if (aEvent.IsConditionDamage) { record.Flags |= EVENTRECORD_FLAG_CONDITION; }
+	if (aEvent.IsCritical)        { record.Flags |= EVENTRECORD_FLAG_CRITICAL; }
+	if (aEvent.IsFumble)          { record.Flags |= EVENTRECORD_FLAG_FUMBLE; }
+
+	s_Head.store(head + 1, std::memory_order_release);
+}
+
+void EventFeed::Dispatch()
+{
+	if (!HasSubscribers()) { return; }
+
+	const std::lock_guard<std::mutex> lock(s_Mutex);
+
+	for (Subscriber_t& sub : s_Subscribers)
+	{
+		uint64_t head = s_Head.load(std::memory_order_acquire);
+
+		if (head == sub.Cursor) { continue; }
+
+		/* The producer never waits, a consumer that fell behind skips ahead. */
+		if (head - sub.Cursor > CMX_EVENTFEED_CAPACITY)
+		{
+			sub.Dropped += (uint32_t)(head - sub.Cursor - CMX_EVENTFEED_CAPACITY);
+			sub.Cursor = head - CMX_EVENTFEED_CAPACITY;
+		}
+
+		s_Batch.clear();
+
+		for (uint64_t i = sub.Cursor; i < head; i++)
+		{
+			s_Batch.push_back(s_Ring[i & (CMX_EVENTFEED_CAPACITY - 1)]);
+		}
+
+		/* Records overwritten while copying are torn, drop them. The slot of
+		 * headAfter may be in the middle of being written as well. */
+		uint64_t headAfter = s_Head.load(std::memory_order_acquire);
+		uint64_t firstValid = headAfter + 1 > CMX_EVENTFEED_CAPACITY ? headAfter + 1 - CMX_EVENTFEED_CAPACITY : 0;
+		size_t   skip = firstValid > sub.Cursor ? (size_t)(firstValid - sub.Cursor) : 0;
+
+		if (skip > s_Batch.size()) { skip = s_Batch.size(); }
+
+		sub.Dropped += (uint32_t)skip;
+
+		/* Agents and skills of these records may be gone, Invalidate holds the same lock. */
+		for (uint64_t i = sub.Cursor + skip; i < s_NamesFrom && i < head; i++)
+		{
+			EventRecord_t& record = s_Batch[(size_t)(i - sub.Cursor)];
+			record.SrcName   = nullptr;
+			record.DstName   = nullptr;
+			record.SkillName = nullptr;
+		}
+
+		sub.Cursor = head;
+
+		if (skip == s_Batch.size()) { continue; }
+
+		sub.Callback(s_Batch.data() + skip, (uint32_t)(s_Batch.size() - skip), sub.Dropped, sub.UserData);
+		sub.Dropped = 0;
+	}
+}
+
+uint32_t EventFeed::Subscribe(EVENTFEED_CALLBACK aCallback, void* aUserData)
+{
+	if (!aCallback) { return 0; }
+
+	const std::lock_guard<std::mutex> lock(s_Mutex);
+
+	uint32_t handle = s_NextHandle++;
+
+	/* New subscribers only see events from now on. */
+	s_Subscribers.push_back(Subscriber_t{ handle, aCallback, aUserData, s_Head.load(std::memory_order_acquire), 0 });
+	s_Count = (uint32_t)s_Subscribers.size();
+
+	return handle;
+}
+
+void EventFeed::Unsubscribe(uint32_t aHandle)
+{
+	const std::lock_guard<std::mutex> lock(s_Mutex);
+
+	for (auto it = s_Subscribers.begin(); it != s_Subscribers.end(); it++)
+	{
+		if (it->Handle == aHandle)
+		{
+			s_Subscribers.erase(it);
+			break;
+		}
+	}
+
+	s_Count = (uint32_t)s_Subscribers.size();
+}
+
+void EventFeed::Invalidate()
+{
+	const std::lock_guard<std::mutex> lock(s_Mutex);
+	s_NamesFrom = s_Head.load(std::memory_order_acquire);
+}
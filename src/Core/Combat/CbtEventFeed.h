@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Nexus/Nexus.h"
+#include "CbtEvent.h"
+#include "EventFeed.h"
+
+/* Host side of the event feed, see EventFeed.h for the consumer side. */
+namespace EventFeed
+{
+	/* Shares the function table through DataLink. */
+	void Create(AddonAPI_t* aApi);
+
+	void Destroy();
+
+	/* Whether anyone is subscribed, events are not converted otherwise. */
+	bool HasSubscribers();
+
+	/* Appends a record, never blocks. Only called by the ingest. */
+	void Push(const CombatEvent_t& aEvent, uint8_t aFlags);
+
+	/* Delivers pending records to every subscriber. Called once per tick. */
+	void Dispatch();
+
+	/* Called before agents or skills are freed, pending records lose their names. */
+	void Invalidate();
+}
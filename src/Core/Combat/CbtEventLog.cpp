@@ -0,0 +1,278 @@
+#include "CbtEventLog.h"
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace EventSpill
+{
+	/* A job without a chunk only releases the file, its removal runs on the writer too. */
+	struct Job_t
+	{
+		std::shared_ptr<EventSpillFile_t> File;
+		std::shared_ptr<EventChunk_t>     Chunk;
+	};
+
+	static std::string             s_Directory;
+	static std::atomic<uint32_t>   s_FileCounter = 0;
+
+	static std::thread             s_Thread;
+	static std::mutex              s_Mutex;
+	static std::condition_variable s_Signal;
+	static std::deque<Job_t>       s_Jobs;
+	static bool                    s_IsRunning   = false;
+
+	void Enqueue(EventLog_t* aLog, const std::shared_ptr<EventChunk_t>& aChunk);
+	void Release(std::shared_ptr<EventSpillFile_t> aFile);
+	void Write(const Job_t& aJob);
+	void ProcessJobs();
+}
+
+EventSpillFile_t::~EventSpillFile_t()
+{
+	std::error_code ec;
+	std::filesystem::remove(this->Path, ec);
+}
+
+EventLog_t::~EventLog_t()
+{
+	this->Clear();
+}
+
+CombatEvent_t* EventLog_t::Append(const CombatEvent_t& aEvent)
+{
+	EventChunk_t* chunk = this->Chunks.empty() ? nullptr : this->Chunks.back().get();
+
+	if (!chunk || chunk->Count.load(std::memory_order_relaxed) == EVENTLOG_CHUNK_SIZE)
+	{
+		/* Seal the full chunk. */
+		if (chunk && this->SpillEnabled && !this->SpillPath.empty())
+		{
+			EventSpill::Enqueue(this, this->Chunks.back());
+		}
+
+		auto next = std::make_shared<EventChunk_t>();
+		next->Events.resize(EVENTLOG_CHUNK_MIN);
+		chunk = next.get();
+
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+		this->Chunks.push_back(std::move(next));
+	}
+
+	uint32_t idx = chunk->Count.load(std::memory_order_relaxed);
+
+	/* Grown under the lock, readers copy from the events while holding it. */
+	if (idx == chunk->Events.size())
+	{
+		size_t size = chunk->Events.size() * 2;
+
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+		chunk->Events.resize(size < EVENTLOG_CHUNK_SIZE ? size : EVENTLOG_CHUNK_SIZE);
+	}
+
+	chunk->Events[idx] = aEvent;
+
+	/* Publish to readers only once the event is written. */
+	chunk->Count.store(idx + 1, std::memory_order_release);
+	this->Count.fetch_add(1, std::memory_order_relaxed);
+
+	return &chunk->Events[idx];
+}
+
+void EventLog_t::Clear()
+{
+	std::shared_ptr<EventSpillFile_t> file;
+
+	{
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+		file.swap(this->SpillFile);
+	}
+
+	/* Writes still pending keep their chunk and the file alive on their own. */
+	if (file)
+	{
+		{
+			const std::lock_guard<std::mutex> lock(file->Mutex);
+			file->Log = nullptr;
+		}
+
+		EventSpill::Release(std::move(file));
+	}
+
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	this->Chunks.clear();
+	this->Count = 0;
+	this->PendingWrites = 0;
+}
+
+size_t EventLog_t::Size() const
+{
+	return this->Count.load(std::memory_order_relaxed);
+}
+
+size_t EventLog_t::GetResidentBytes() const
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	size_t bytes = this->Chunks.capacity() * sizeof(EventChunk_t*);
+
+	for (const std::shared_ptr<EventChunk_t>& chunk : this->Chunks)
+	{
+		bytes += sizeof(EventChunk_t) + chunk->Events.capacity() * sizeof(CombatEvent_t);
+	}
+
+	return bytes;
+}
+
+bool EventLog_t::PageIn(uint64_t aOffset, uint32_t aFirst, uint32_t aCount, std::vector<CombatEvent_t>& aOut) const
+{
+	std::ifstream file(this->SpillPath, std::ios::binary);
+
+	if (!file.is_open()) { return false; }
+
+	aOut.resize(aCount);
+
+	file.seekg(aOffset + (uint64_t)aFirst * sizeof(CombatEvent_t));
+	file.read((char*)aOut.data(), aCount * sizeof(CombatEvent_t));
+
+	return file.good();
+}
+
+void EventSpill::Create(const std::string& aDirectory)
+{
+	s_Directory = aDirectory;
+
+	/* Leftovers of a previous session are never read again. */
+	std::error_code ec;
+	std::filesystem::remove_all(s_Directory, ec);
+	std::filesystem::create_directories(s_Directory, ec);
+
+	const std::lock_guard<std::mutex> lock(s_Mutex);
+	if (s_IsRunning) { return; }
+
+	s_IsRunning = true;
+	s_Thread = std::thread(ProcessJobs);
+}
+
+void EventSpill::Destroy()
+{
+	{
+		const std::lock_guard<std::mutex> lock(s_Mutex);
+		s_IsRunning = false;
+	}
+	s_Signal.notify_all();
+
+	if (s_Thread.joinable())
+	{
+		s_Thread.join();
+	}
+}
+
+std::string EventSpill::GetSpillPath()
+{
+	if (s_Directory.empty()) { return std::string(); }
+
+	return (std::filesystem::path(s_Directory) / ("events_" + std::to_string(s_FileCounter++) + ".bin")).string();
+}
+
+void EventSpill::Enqueue(EventLog_t* aLog, const std::shared_ptr<EventChunk_t>& aChunk)
+{
+	{
+		const std::lock_guard<std::mutex> lock(s_Mutex);
+
+		/* Without the writer the chunk stays resident. */
+		if (!s_IsRunning) { return; }
+
+		const std::lock_guard<std::mutex> logLock(aLog->Mutex);
+
+		if (!aLog->SpillFile)
+		{
+			aLog->SpillFile = std::make_shared<EventSpillFile_t>();
+			aLog->SpillFile->Path = aLog->SpillPath;
+			aLog->SpillFile->Log  = aLog;
+		}
+
+		aLog->PendingWrites++;
+
+		s_Jobs.push_back(Job_t{ aLog->SpillFile, aChunk });
+	}
+	s_Signal.notify_one();
+}
+
+void EventSpill::Release(std::shared_ptr<EventSpillFile_t> aFile)
+{
+	{
+		const std::lock_guard<std::mutex> lock(s_Mutex);
+
+		/* Without the writer the file is removed right here. */
+		if (!s_IsRunning) { return; }
+
+		s_Jobs.push_back(Job_t{ std::move(aFile), nullptr });
+	}
+	s_Signal.notify_one();
+}
+
+void EventSpill::Write(const Job_t& aJob)
+{
+	if (!aJob.Chunk) { return; }
+
+	uint32_t count = aJob.Chunk->Count.load(std::memory_order_acquire);
+
+	/* Events only reference agents and skills owned by the encounter, which
+	 * outlives its spill file, so the raw bytes can be paged back in as is. */
+	std::ofstream file(aJob.File->Path, std::ios::binary | std::ios::app);
+
+	uint64_t offset = 0;
+	bool     success = false;
+
+	if (file.is_open())
+	{
+		file.seekp(0, std::ios::end);
+		offset = (uint64_t)file.tellp();
+		file.write((const char*)aJob.Chunk->Events.data(), count * sizeof(CombatEvent_t));
+		success = file.good();
+	}
+
+	const std::lock_guard<std::mutex> fileLock(aJob.File->Mutex);
+
+	/* Cleared meanwhile, the chunk is freed with the job. */
+	EventLog_t* log = aJob.File->Log;
+
+	if (!log) { return; }
+
+	const std::lock_guard<std::mutex> lock(log->Mutex);
+
+	/* On failure the chunk simply stays resident. */
+	if (success)
+	{
+		aJob.Chunk->FileOffset = offset;
+		aJob.Chunk->IsSpilled  = true;
+		std::vector<CombatEvent_t>().swap(aJob.Chunk->Events);
+	}
+
+	log->PendingWrites--;
+}
+
+void EventSpill::ProcessJobs()
+{
+	for (;;)
+	{
+		Job_t job;
+
+		{
+			std::unique_lock<std::mutex> lock(s_Mutex);
+			s_Signal.wait(lock, [] { return !s_IsRunning || !s_Jobs.empty(); });
+
+			/* Pending jobs are still written on shutdown. */
+			if (s_Jobs.empty()) { return; }
+
+			job = std::move(s_Jobs.front());
+			s_Jobs.pop_front();
+		}
+
+		Write(job);
+	}
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "CbtEvent.h"
+
+/* Number of events per chunk. */
+#define EVENTLOG_CHUNK_SIZE 4096
+
+/* Events a chunk starts with, it doubles up to EVENTLOG_CHUNK_SIZE. */
+#define EVENTLOG_CHUNK_MIN  16
+
+struct EventLog_t;
+
+struct EventChunk_t
+{
+	std::vector<CombatEvent_t> Events;         // Grows with Count, empty once spilled.
+	std::atomic<uint32_t>      Count      = 0;
+	bool                       IsSpilled  = false;
+	uint64_t                   FileOffset = 0;
+};
+
+/* Spill file of a log, shared with the writes still pending for it. The log
+ * detaches on Clear() without waiting, writes finishing later find no log to
+ * update. The file is removed with the last owner. */
+struct EventSpillFile_t
+{
+	std::string                Path;
+
+	std::mutex                 Mutex;        // Guards Log, taken before the log mutex.
+	EventLog_t*                Log           = nullptr;
+
+	~EventSpillFile_t();
+};
+
+/* Append-only combat event storage in chunks of up to EVENTLOG_CHUNK_SIZE.
+ * With spilling enabled, full chunks are written to a temporary file on a
+ * background thread and only the active chunk stays resident. */
+struct EventLog_t
+{
+	bool                       SpillEnabled  = false;
+	std::string                SpillPath;
+
+	std::vector<std::shared_ptr<EventChunk_t>> Chunks;
+	std::atomic<size_t>        Count         = 0;
+
+	mutable std::mutex         Mutex;        // Guards chunk list, chunk growth and spill state.
+	uint32_t                   PendingWrites = 0;
+
+	std::shared_ptr<EventSpillFile_t> SpillFile; // Created with the first spilled chunk.
+
+	~EventLog_t();
+
+	/* Stores the event at the end of the log. Only called by the ingest.
+	 * The returned event stays valid until the next Append(). */
+	CombatEvent_t* Append(const CombatEvent_t& aEvent);
+
+	/* Visits every event in order, spilled chunks are paged in from disk. */
+	template<typename F>
+	inline void ForEach(F aCallback)
+	{
+		this->ForEachFrom(0, SIZE_MAX, [&aCallback](const CombatEvent_t& aEvent)
+		{
+			aCallback(aEvent);
+			return true;
+		});
+	}
+
+	/* Visits the events in [aFirst, aEnd) in order until the callback returns false.
+	 * The lock is only held to copy resident events, disk reads never block Append. */
+	template<typename F>
+	inline void ForEachFrom(size_t aFirst, size_t aEnd, F aCallback)
+	{
+		std::vector<CombatEvent_t> events;
+
+		for (size_t idx = aFirst; idx < aEnd;)
+		{
+			size_t   chunkIdx  = idx / EVENTLOG_CHUNK_SIZE;
+			uint32_t first     = (uint32_t)(idx % EVENTLOG_CHUNK_SIZE);
+			uint32_t count     = 0;
+			bool     isSpilled = false;
+			uint64_t offset    = 0;
+
+			{
+				const std::lock_guard<std::mutex> lock(this->Mutex);
+
+				if (chunkIdx >= this->Chunks.size()) { return; }
+
+				const EventChunk_t* chunk = this->Chunks[chunkIdx].get();
+				count = chunk->Count.load(std::memory_order_acquire);
+
+				if (first >= count) { return; }
+
+				if (count - first > aEnd - idx)
+				{
+					count = first + (uint32_t)(aEnd - idx);
+				}
+
+				isSpilled = chunk->IsSpilled;
+				offset    = chunk->FileOffset;
+
+				/* Copied, the spill writer may free the events once the lock is released. */
+				if (!isSpilled)
+				{
+					events.assign(chunk->Events.begin() + first, chunk->Events.begin() + count);
+				}
+			}
+
+			idx = chunkIdx * EVENTLOG_CHUNK_SIZE + count;
+
+			/* Unreadable chunks are skipped. */
+			if (isSpilled && !this->PageIn(offset, first, count - first, events)) { continue; }
+
+			for (const CombatEvent_t& ev : events)
+			{
+				if (!aCallback(ev)) { return; }
+			}
+		}
+	}
+
+	/* Frees all chunks and detaches from pending writes, never waits for them.
+	 * The spill file is removed by the writer once it is done with it. */
+	void Clear();
+
+	size_t Size() const;
+
+	/* Bytes held in memory, spilled chunks excluded. */
+	size_t GetResidentBytes() const;
+
+	/* Reads aCount events starting at aFirst of the chunk spilled at aOffset. */
+	bool PageIn(uint64_t aOffset, uint32_t aFirst, uint32_t aCount, std::vector<CombatEvent_t>& aOut) const;
+};
+
+namespace EventSpill
+{
+	/* Starts the writer thread, spill files are placed in the given directory. */
+	void Create(const std::string& aDirectory);
+
+	void Destroy();
+
+	/* Unique file path for a new event log. */
+	std::string GetSpillPath();
+}
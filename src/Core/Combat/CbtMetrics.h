@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "CbtEvent.h"
+#include "CbtSketch.h"
+#include "CbtStats.h"
+
+/* Metrics are small policy types composed at compile time into one pass.
+ * Each policy provides:
+ *   void Accept(const CombatEvent_t& aEvent, const Stats_t& aDelta);
+ *   void Merge(const Self& aOther);
+ *   void Finalize(uint64_t aDuration);
+ * aDelta is the event already classified into damage, heal or barrier. */
+
+/* Damage hits, critical hits and fumbles. */
+struct HitCount_t
+{
+	uint32_t Hits    = 0;
+	uint32_t Crits   = 0;
+	uint32_t Fumbles = 0;
+
+	inline void Accept(const CombatEvent_t& aEvent, const Stats_t& aDelta)
+	{
+		if (aDelta.Damage >= 0.f) { return; }
+
+		this->Hits++;
+		this->Crits   += aEvent.IsCritical;
+		this->Fumbles += aEvent.IsFumble;
+	}
+
+	inline void Merge(const HitCount_t& aOther)
+	{
+		this->Hits    += aOther.Hits;
+		this->Crits   += aOther.Crits;
+		this->Fumbles += aOther.Fumbles;
+	}
+
+	inline void Finalize(uint64_t) {}
+
+	inline float CritRate() const
+	{
+		return this->Hits ? (float)this->Crits / this->Hits : 0.f;
+	}
+};
+
+/* Damage split into power and condition damage. Both are negative like Stats_t::Damage. */
+struct DamageSplit_t
+{
+	float Power     = 0.f;
+	float Condition = 0.f;
+
+	inline void Accept(const CombatEvent_t& aEvent, const Stats_t& aDelta)
+	{
+		if (aEvent.IsConditionDamage)
+		{
+			this->Condition += aDelta.Damage;
+		}
+		else
+		{
+			this->Power += aDelta.Damage;
+		}
+	}
+
+	inline void Merge(const DamageSplit_t& aOther)
+	{
+		this->Power     += aOther.Power;
+		this->Condition += aOther.Condition;
+	}
+
+	inline void Finalize(uint64_t) {}
+};
+
+/* Smallest and largest single damage hit, as positive values. */
+struct HitRange_t
+{
+	float    MinHit  = 0.f;
+	float    MaxHit  = 0.f;
+	bool     HasHit  = false;
+
+	inline void Accept(const CombatEvent_t&, const Stats_t& aDelta)
+	{
+		if (aDelta.Damage >= 0.f) { return; }
+
+		float value = -aDelta.Damage;
+
+		if (!this->HasHit || value < this->MinHit) { this->MinHit = value; }
+		if (!this->HasHit || value > this->MaxHit) { this->MaxHit = value; }
+
+		this->HasHit = true;
+	}
+
+	inline void Merge(const HitRange_t& aOther)
+	{
+		if (!aOther.HasHit) { return; }
+
+		if (!this->HasHit || aOther.MinHit < this->MinHit) { this->MinHit = aOther.MinHit; }
+		if (!this->HasHit || aOther.MaxHit > this->MaxHit) { this->MaxHit = aOther.MaxHit; }
+
+		this->HasHit = true;
+	}
+
+	inline void Finalize(uint64_t) {}
+};
+
+/* Distribution of damage hit sizes, as positive values. */
+struct HitQuantiles_t
+{
+	QuantileSketch_t HitSizes;
+
+	inline void Accept(const CombatEvent_t&, const Stats_t& aDelta)
+	{
+		if (aDelta.Damage >= 0.f) { return; }
+
+		this->HitSizes.Add(-aDelta.Damage);
+	}
+
+	inline void Merge(const HitQuantiles_t& aOther)
+	{
+		this->HitSizes.Merge(aOther.HitSizes);
+	}
+
+	inline void Finalize(uint64_t)
+	{
+		this->HitSizes.Buckets.shrink_to_fit();
+	}
+};
+
+/* Set of metric policies fused into a single inlined pass per event.
+ * Policies that are not listed are not compiled in. */
+template<typename... Ms>
+struct Metrics_t : Ms...
+{
+	template<typename M>
+	static constexpr bool Has = (std::is_same_v<M, Ms> || ...);
+
+	inline void Accept(const CombatEvent_t& aEvent, const Stats_t& aDelta)
+	{
+		(Ms::Accept(aEvent, aDelta), ...);
+	}
+
+	inline void Merge(const Metrics_t& aOther)
+	{
+		(Ms::Merge(static_cast<const Ms&>(aOther)), ...);
+	}
+
+	inline void Finalize(uint64_t aDuration)
+	{
+		(Ms::Finalize(aDuration), ...);
+	}
+
+	template<typename M>
+	inline const M& Get() const
+	{
+		static_assert(Has<M>, "Metric is not part of this set.");
+		return static_cast<const M&>(*this);
+	}
+};
+
+/* Classifies a health event into damage, heal or barrier. */
+inline Stats_t ClassifyEvent(const CombatEvent_t& aEvent)
+{
+	Stats_t delta{};
+
+	if (aEvent.Value < 0)
+	{
+		/* Damage */
+		delta.Damage = aEvent.Value;
+	}
+	else if (aEvent.Value > 0)
+	{
+		/* Heal */
+		delta.Heal = aEvent.Value;
+	}
+	else if (aEvent.ValueAlt > 0)
+	{
+		/* Barrier */
+		delta.Barrier = aEvent.ValueAlt;
+	}
+
+	return delta;
+}
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "CbtStats.h"
+
+struct PhaseRule_t
+{
+	uint32_t SpeciesID;   // Trigger species this rule applies to.
+	uint32_t TimeGap;     // Gap in ms between outgoing target hits that starts a new phase. 0 to disable.
+	bool     TargetSwap;  // Start a new phase when outgoing target damage moves to another species.
+	bool     TargetDeath; // Start a new phase when a target species goes down or dies.
+};
+
+struct Phase_t
+{
+	uint32_t TimeStart = 0; // ms relative to encounter start
+	uint32_t TimeEnd   = 0; // ms relative to encounter start
+	uint32_t SpeciesID = 0; // Target species the phase was spent on.
+
+	Stats_t  OutTarget = {};
+	Stats_t  OutCleave = {};
+	Stats_t  InTarget  = {};
+	Stats_t  InCleave  = {};
+};
+
+/* Splits an encounter into phases as events arrive. Every call is O(1).
+ * Phases never share a ms: the previous phase ends right before the next
+ * one starts, so inclusive window queries count every event once. */
+struct PhaseTracker_t
+{
+	PhaseRule_t          Rule           = {}; // Copied, the species table may be swapped mid-encounter.
+
+	uint32_t             LastTargetHit  = 0;
+	bool                 HasTargetHit   = false;
+	uint32_t             LastDownedID   = 0;     // Target that went down last, its death splits no further.
+
+	uint32_t             LastEventTime  = 0;     // Latest event in the current phase.
+	bool                 IsSplitPending = false; // Split requested in the ms of the latest event.
+
+	std::vector<Phase_t> Phases;
+
+	inline Phase_t& Current(uint32_t aTime)
+	{
+		if (this->Phases.empty())
+		{
+			this->Start(aTime);
+		}
+		else if (this->IsSplitPending && aTime > this->LastEventTime)
+		{
+			this->Start(aTime);
+		}
+
+		Phase_t& phase = this->Phases.back();
+		phase.TimeEnd = aTime > phase.TimeEnd ? aTime : phase.TimeEnd;
+		return phase;
+	}
+
+	/* Requests a new phase from aTime on. Events in the same ms as the latest
+	 * event still belong to the current phase, the new phase then starts with
+	 * the next later event. */
+	inline void Split(uint32_t aTime)
+	{
+		if (this->Phases.empty())
+		{
+			this->Start(aTime);
+			return;
+		}
+
+		Phase_t& last = this->Phases.back();
+
+		/* Nothing happened in the current phase yet, e.g. two targets dying together. */
+		if (last.OutCleave.IsEmpty() && last.InCleave.IsEmpty())
+		{
+			last.SpeciesID = 0;
+			return;
+		}
+
+		if (aTime > this->LastEventTime)
+		{
+			this->Start(aTime);
+		}
+		else
+		{
+			this->IsSplitPending = true;
+		}
+	}
+
+	/* Closes the current phase right before aTime and opens the next one. */
+	inline void Start(uint32_t aTime)
+	{
+		if (!this->Phases.empty())
+		{
+			Phase_t& last = this->Phases.back();
+
+			if (last.TimeEnd >= aTime)
+			{
+				last.TimeEnd = aTime > last.TimeStart ? aTime - 1 : last.TimeStart;
+			}
+		}
+
+		Phase_t phase{};
+		phase.TimeStart = aTime;
+		phase.TimeEnd   = aTime;
+		this->Phases.push_back(phase);
+
+		this->IsSplitPending = false;
+	}
+
+	inline void OnOutgoing(uint32_t aTime, uint32_t aSpeciesID, bool aIsTarget, const Stats_t& aDelta)
+	{
+		bool isTargetHit = aIsTarget && aDelta.Damage < 0.f;
+
+		if (isTargetHit)
+		{
+			if (this->Rule.TimeGap && this->HasTargetHit && aTime - this->LastTargetHit > this->Rule.TimeGap)
+			{
+				this->Split(aTime);
+			}
+
+			this->LastTargetHit = aTime;
+			this->HasTargetHit  = true;
+		}
+
+		Phase_t* phase = &this->Current(aTime);
+
+		if (isTargetHit)
+		{
+			if (phase->SpeciesID == 0)
+			{
+				phase->SpeciesID = aSpeciesID;
+			}
+			else if (this->Rule.TargetSwap && phase->SpeciesID != aSpeciesID)
+			{
+				this->Split(aTime);
+
+				/* A pending split keeps the hit in the current phase. */
+				phase = &this->Phases.back();
+				phase->SpeciesID = phase->OutCleave.IsEmpty() && phase->InCleave.IsEmpty() ? aSpeciesID : phase->SpeciesID;
+			}
+		}
+
+		phase->OutCleave += aDelta;
+
+		if (aIsTarget)
+		{
+			phase->OutTarget += aDelta;
+		}
+
+		this->OnEvent(aTime);
+	}
+
+	inline void OnIncoming(uint32_t aTime, bool aIsTarget, const Stats_t& aDelta)
+	{
+		Phase_t& phase = this->Current(aTime);
+
+		phase.InCleave += aDelta;
+
+		if (aIsTarget)
+		{
+			phase.InTarget += aDelta;
+		}
+
+		this->OnEvent(aTime);
+	}
+
+	/* A target going down ends the phase like its death would. */
+	inline void OnTargetDown(uint32_t aTime, uint32_t aAgentID)
+	{
+		this->Current(aTime);
+
+		this->LastDownedID = aAgentID;
+
+		if (this->Rule.TargetDeath)
+		{
+			this->Split(aTime);
+		}
+	}
+
+	inline void OnTargetDeath(uint32_t aTime, uint32_t aAgentID)
+	{
+		this->Current(aTime);
+
+		/* Already split when it went down. */
+		if (aAgentID && aAgentID == this->LastDownedID)
+		{
+			this->LastDownedID = 0;
+			return;
+		}
+
+		if (this->Rule.TargetDeath)
+		{
+			/* Species of the new phase is picked up on the next target hit. */
+			this->Split(aTime);
+		}
+	}
+
+	inline void OnEvent(uint32_t aTime)
+	{
+		this->LastEventTime = aTime > this->LastEventTime ? aTime : this->LastEventTime;
+	}
+
+	/* Drops a trailing phase that never received any events. */
+	inline void Finalize()
+	{
+		if (this->Phases.size() > 1)
+		{
+			const Phase_t& last = this->Phases.back();
+
+			if (last.OutCleave.IsEmpty() && last.InCleave.IsEmpty())
+			{
+				this->Phases.pop_back();
+			}
+		}
+	}
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+
+#include "CbtAgent.h"
+#include "CbtEvent.h"
+
+/* Number of incoming hits the ring holds. Heavy incoming traffic can exceed
+ * it within RECAP_WINDOW, the recap is then marked as truncated. */
+#define RECAP_CAPACITY 256
+
+/* Time in ms before a down or death that is part of the recap. */
+#define RECAP_WINDOW   10000
+
+struct RecapHit_t
+{
+	uint64_t Time;
+	Agent_t* SrcAgent;
+	Skill_t* Skill;
+	float    Value;
+};
+
+/* Incoming hits leading up to a down or death, oldest first. */
+struct DeathRecap_t
+{
+	ECombatEventType Type;
+	uint64_t         Time;
+	uint32_t         Count;
+	bool             IsTruncated; // Hits within the window were overwritten, the recap starts later.
+	RecapHit_t       Hits[RECAP_CAPACITY];
+};
+
+/* Fixed size ring of the latest incoming hits. */
+struct RecapRing_t
+{
+	RecapHit_t Hits[RECAP_CAPACITY] = {};
+	uint32_t   Next                 = 0;
+	uint32_t   Count                = 0;
+	uint64_t   EvictedTime          = 0; // Time of the latest overwritten hit.
+	bool       HasEvicted           = false;
+
+	inline void Push(const RecapHit_t& aHit)
+	{
+		if (this->Count == RECAP_CAPACITY)
+		{
+			this->EvictedTime = this->Hits[this->Next].Time;
+			this->HasEvicted  = true;
+		}
+
+		this->Hits[this->Next] = aHit;
+		this->Next = (this->Next + 1) % RECAP_CAPACITY;
+
+		if (this->Count < RECAP_CAPACITY)
+		{
+			this->Count++;
+		}
+	}
+
+	inline void Clear()
+	{
+		this->Next       = 0;
+		this->Count      = 0;
+		this->HasEvicted = false;
+	}
+
+	/* Copies the hits within RECAP_WINDOW before aTime into the recap. */
+	inline void Freeze(DeathRecap_t& aRecap, ECombatEventType aType, uint64_t aTime) const
+	{
+		aRecap.Type  = aType;
+		aRecap.Time  = aTime;
+		aRecap.Count = 0;
+
+		aRecap.IsTruncated = this->HasEvicted && this->EvictedTime + RECAP_WINDOW >= aTime;
+
+		uint32_t oldest = (this->Next + RECAP_CAPACITY - this->Count) % RECAP_CAPACITY;
+
+		for (uint32_t i = 0; i < this->Count; i++)
+		{
+			const RecapHit_t& hit = this->Hits[(oldest + i) % RECAP_CAPACITY];
+
+			if (hit.Time + RECAP_WINDOW < aTime) { continue; }
+
+			aRecap.Hits[aRecap.Count++] = hit;
+		}
+	}
+};
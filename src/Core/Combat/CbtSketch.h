@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "Core/LogBuckets.h"
+
+/* Mergeable quantile sketch over positive values.
+ * Values are counted in log-linear buckets, see LogBuckets.h, and only
+ * non-empty buckets are stored, so memory is bounded by the value range
+ * and not by the number of values. Estimates are within ~3%. */
+struct QuantileSketch_t
+{
+	struct Bucket_t
+	{
+		uint16_t Index;
+		uint32_t Count;
+	};
+
+	std::vector<Bucket_t> Buckets; // Sorted by index.
+	uint64_t              Count   = 0;
+	float                 Min     = 0.f;
+	float                 Max     = 0.f;
+
+	inline void Add(float aValue)
+	{
+		uint16_t index = (uint16_t)LogBuckets::Index((uint64_t)(aValue + 0.5f));
+
+		auto it = std::lower_bound(this->Buckets.begin(), this->Buckets.end(), index, [](const Bucket_t& aBucket, uint16_t aIndex)
+		{
+			return aBucket.Index < aIndex;
+		});
+
+		if (it != this->Buckets.end() && it->Index == index)
+		{
+			it->Count++;
+		}
+		else
+		{
+			this->Buckets.insert(it, Bucket_t{ index, 1 });
+		}
+
+		if (this->Count == 0 || aValue < this->Min) { this->Min = aValue; }
+		if (this->Count == 0 || aValue > this->Max) { this->Max = aValue; }
+
+		this->Count++;
+	}
+
+	inline void Merge(const QuantileSketch_t& aOther)
+	{
+		if (aOther.Count == 0) { return; }
+
+		std::vector<Bucket_t> merged;
+		merged.reserve(this->Buckets.size() + aOther.Buckets.size());
+
+		size_t a = 0;
+		size_t b = 0;
+
+		while (a < this->Buckets.size() || b < aOther.Buckets.size())
+		{
+			if (b == aOther.Buckets.size() || (a < this->Buckets.size() && this->Buckets[a].Index < aOther.Buckets[b].Index))
+			{
+				merged.push_back(this->Buckets[a++]);
+			}
+			else if (a == this->Buckets.size() || aOther.Buckets[b].Index < this->Buckets[a].Index)
+			{
+				merged.push_back(aOther.Buckets[b++]);
+			}
+			else
+			{
+				merged.push_back(Bucket_t{ this->Buckets[a].Index, this->Buckets[a].Count + aOther.Buckets[b].Count });
+				a++;
+				b++;
+			}
+		}
+
+		this->Buckets.swap(merged);
+
+		if (this->Count == 0 || aOther.Min < this->Min) { this->Min = aOther.Min; }
+		if (this->Count == 0 || aOther.Max > this->Max) { this->Max = aOther.Max; }
+
+		this->Count += aOther.Count;
+	}
+
+	/* Approximate value at the given quantile [0, 1]. */
+	inline float Quantile(double aQuantile) const
+	{
+		if (this->Count == 0) { return 0.f; }
+
+		uint64_t rank = (uint64_t)(aQuantile * (this->Count - 1));
+		uint64_t seen = 0;
+
+		for (const Bucket_t& bucket : this->Buckets)
+		{
+			seen += bucket.Count;
+
+			if (seen > rank)
+			{
+				/* Middle of the bucket, clamped to the observed range. */
+				float lower = (float)LogBuckets::Value(bucket.Index);
+				float upper = (float)LogBuckets::Value(bucket.Index + 1);
+				float value = (lower + upper) / 2.f;
+
+				return value < this->Min ? this->Min : value > this->Max ? this->Max : value;
+			}
+		}
+
+		return this->Max;
+	}
+
+	inline size_t GetMemoryUsage() const
+	{
+		return this->Buckets.capacity() * sizeof(Bucket_t);
+	}
+};
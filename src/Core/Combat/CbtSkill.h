@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+#include "CbtMetrics.h"
+#include "Core/Format.h"
+
+/* Metrics kept per skill for outgoing hits. */
+using SkillMetrics_t = Metrics_t<Stats_t, HitCount_t, HitQuantiles_t>;
+
+struct Skill_t
+{
+	uint32_t       ID;
+	char           Name[128];
+
+	SkillMetrics_t Out = {};
+
+	bool           IsBuff      = false; // Tracked as buff, its ticks are no casts.
+	bool           IsUsedAlive = false; // Cast by an agent that was alive, so it is no downed skill.
+
+	/* Name without allocating, the fallback is written into the buffer. */
+	inline const char* GetName(char* aBuffer, size_t aSize) const
+	{
+		if (this->Name[0])
+		{
+			return this->Name;
+		}
+
+		size_t length = 0;
+		aBuffer[0] = '\0';
+
+		Format::Append(aBuffer, aSize, length, "sk-");
+		return Format::AppendInteger(aBuffer, aSize, length, this->ID);
+	}
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+#include "CbtAgent.h"
+#include "CbtStats.h"
+
+/* Accumulated stats of an agent and everything it summoned. */
+struct AgentStats_t
+{
+	Stats_t OutTarget = {};
+	Stats_t OutCleave = {};
+	Stats_t InCleave  = {};
+};
+
+/* Row of the squad table, published by the ingest for the UI. */
+struct SquadMember_t
+{
+	Agent_t*     Agent;
+	AgentStats_t Stats;
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+enum class EAgentState : uint8_t
+{
+	Alive,
+	Downed,
+	Dead
+};
+
+/* State transitions of one agent, sorted by time. Every agent starts alive,
+ * the time spent downed and dead before each transition is kept so any
+ * query is a single binary search. */
+struct StateTimeline_t
+{
+	struct Change_t
+	{
+		uint32_t    Time;         // ms relative to encounter start
+		uint32_t    DownedBefore; // ms spent downed up to Time.
+		uint32_t    DeadBefore;   // ms spent dead up to Time.
+		EAgentState State;
+	};
+
+	std::vector<Change_t> Changes;
+
+	inline EAgentState Current() const
+	{
+		return this->Changes.empty() ? EAgentState::Alive : this->Changes.back().State;
+	}
+
+	/* Appends a transition, repeated states are ignored. Times never go backwards. */
+	inline void Set(uint32_t aTime, EAgentState aState)
+	{
+		if (this->Current() == aState) { return; }
+
+		Change_t change{ aTime, 0, 0, aState };
+
+		if (!this->Changes.empty())
+		{
+			const Change_t& last = this->Changes.back();
+
+			change.Time         = aTime > last.Time ? aTime : last.Time;
+			change.DownedBefore = last.DownedBefore + (last.State == EAgentState::Downed ? change.Time - last.Time : 0);
+			change.DeadBefore   = last.DeadBefore   + (last.State == EAgentState::Dead   ? change.Time - last.Time : 0);
+		}
+
+		this->Changes.push_back(change);
+	}
+
+	/* State at the given time. O(log n). */
+	inline EAgentState StateAt(uint32_t aTime) const
+	{
+		const Change_t* change = this->Find(aTime);
+
+		return change ? change->State : EAgentState::Alive;
+	}
+
+	inline bool IsAliveAt(uint32_t aTime) const
+	{
+		return this->StateAt(aTime) == EAgentState::Alive;
+	}
+
+	/* ms spent in the state within [aTimeStart, aTimeEnd). O(log n). */
+	inline uint32_t TimeIn(EAgentState aState, uint32_t aTimeStart, uint32_t aTimeEnd) const
+	{
+		if (aTimeEnd <= aTimeStart) { return 0; }
+
+		return this->TimeInUntil(aState, aTimeEnd) - this->TimeInUntil(aState, aTimeStart);
+	}
+
+	/* Last transition at or before the given time, nullptr while still in the initial state. */
+	inline const Change_t* Find(uint32_t aTime) const
+	{
+		auto it = std::upper_bound(this->Changes.begin(), this->Changes.end(), aTime, [](uint32_t aValue, const Change_t& aChange) {
+			return aValue < aChange.Time;
+		});
+
+		return it == this->Changes.begin() ? nullptr : &*(it - 1);
+	}
+
+	/* ms spent in the state from encounter start until the given time. */
+	inline uint32_t TimeInUntil(EAgentState aState, uint32_t aTime) const
+	{
+		const Change_t* change = this->Find(aTime);
+
+		if (!change)
+		{
+			return aState == EAgentState::Alive ? aTime : 0;
+		}
+
+		uint32_t open = change->State == aState ? aTime - change->Time : 0;
+
+		switch (aState)
+		{
+			case EAgentState::Downed: return change->DownedBefore + open;
+			case EAgentState::Dead:   return change->DeadBefore + open;
+			default:                  return change->Time - change->DownedBefore - change->DeadBefore + open;
+		}
+	}
+};
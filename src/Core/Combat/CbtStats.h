@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+
+struct CombatEvent_t;
+
+/* Damage, heal and barrier totals. Damage is negative. */
+struct Stats_t
+{
+	float Damage  = 0.f;
+	float Heal    = 0.f;
+	float Barrier = 0.f;
+
+	inline Stats_t& operator+=(const Stats_t& aOther)
+	{
+		this->Damage  += aOther.Damage;
+		this->Heal    += aOther.Heal;
+		this->Barrier += aOther.Barrier;
+		return *this;
+	}
+
+	/* Metric policy, see CbtMetrics.h. */
+	inline void Accept(const CombatEvent_t&, const Stats_t& aDelta)
+	{
+		*this += aDelta;
+	}
+
+	inline void Merge(const Stats_t& aOther)
+	{
+		*this += aOther;
+	}
+
+	inline void Finalize(uint64_t) {}
+
+	inline bool IsEmpty() const
+	{
+		return this->Damage == 0.f && this->Heal == 0.f && this->Barrier == 0.f;
+	}
+};
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "CbtEvent.h"
+#include "CbtStats.h"
+
+/* Interval in ms at which cumulative samples are taken. */
+#define TIMEINDEX_SAMPLE_INTERVAL 1000
+
+/* Channel bits, marked on the events in CombatEvent_t::Channels. */
+#define TIMEINDEX_CHANNEL_OUTTARGET 1
+#define TIMEINDEX_CHANNEL_OUTCLEAVE 2
+#define TIMEINDEX_CHANNEL_INTARGET  4
+#define TIMEINDEX_CHANNEL_INCLEAVE  8
+
+/* Prefix sums of a single Stats_t channel over time.
+ * Times are ms relative to the encounter start.
+ * A cumulative sample is taken every TIMEINDEX_SAMPLE_INTERVAL, and every distinct
+ * event time keeps a point with the sums since that sample. A bound within an
+ * interval is a binary search over the points of the interval, the event log is
+ * never read. Points are 16 bytes per distinct ms and stay resident. */
+struct TimeIndex_t
+{
+	struct Entry_t
+	{
+		uint32_t Time     = 0;
+		uint32_t Position = 0; // Index of the first point not contained.
+		double   Damage   = 0;
+		double   Heal     = 0;
+		double   Barrier  = 0;
+	};
+
+	/* Sums of the interval up to and including Time, relative to its sample.
+	 * One interval never sums up to more than a float holds exactly. */
+	struct Point_t
+	{
+		uint32_t Time    = 0;
+		float    Damage  = 0;
+		float    Heal    = 0;
+		float    Barrier = 0;
+	};
+
+	bool                 IsFinalized = false;
+
+	uint32_t             Channel     = 0;
+
+	Entry_t              Total;           // Sums of all events, Time is the latest event time.
+	std::vector<Entry_t> Samples;         // Sums of all events before every TIMEINDEX_SAMPLE_INTERVAL.
+	std::vector<Point_t> Points;          // Ascending by time.
+
+	inline void Bind(uint32_t aChannel)
+	{
+		this->Channel = aChannel;
+	}
+
+	/* Adds the event at its time relative to the encounter start. */
+	inline void Add(CombatEvent_t& aEvent, uint32_t aTime, const Stats_t& aDelta)
+	{
+		if (aDelta.IsEmpty()) { return; }
+
+		/* Event times may jitter slightly, keep the index monotonic. */
+		uint32_t time = aTime > this->Total.Time ? aTime : this->Total.Time;
+
+		this->SampleUntil(time);
+
+		aEvent.Channels |= this->Channel;
+
+		this->Total.Time     = time;
+		this->Total.Damage  += aDelta.Damage;
+		this->Total.Heal    += aDelta.Heal;
+		this->Total.Barrier += aDelta.Barrier;
+
+		/* SampleUntil() pushed the sample of this interval last. */
+		const Entry_t& sample = this->Samples.back();
+
+		Point_t point{};
+		point.Time    = time;
+		point.Damage  = (float)(this->Total.Damage - sample.Damage);
+		point.Heal    = (float)(this->Total.Heal - sample.Heal);
+		point.Barrier = (float)(this->Total.Barrier - sample.Barrier);
+
+		if (this->Points.size() > sample.Position && this->Points.back().Time == time)
+		{
+			this->Points.back() = point;
+		}
+		else
+		{
+			this->Points.push_back(point);
+		}
+	}
+
+	/* Seals the index at combat end. Samples cover the full duration afterwards. */
+	inline void Finalize(uint32_t aDuration)
+	{
+		if (this->IsFinalized) { return; }
+
+		this->SampleUntil(aDuration);
+		this->Samples.shrink_to_fit();
+		this->Points.shrink_to_fit();
+		this->IsFinalized = true;
+	}
+
+	/* Cumulative sums of all events at or before aTime. */
+	inline Entry_t Sum(uint32_t aTime) const
+	{
+		return aTime == UINT32_MAX ? this->Total : this->Prefix(aTime + 1);
+	}
+
+	/* Stats within the window [aTimeStart, aTimeEnd]. */
+	inline Stats_t Query(uint32_t aTimeStart, uint32_t aTimeEnd) const
+	{
+		if (aTimeEnd < aTimeStart) { return Stats_t{}; }
+
+		Entry_t start = this->Prefix(aTimeStart);
+		Entry_t end   = this->Sum(aTimeEnd);
+
+		Stats_t result{};
+		result.Damage  = (float)(end.Damage - start.Damage);
+		result.Heal    = (float)(end.Heal - start.Heal);
+		result.Barrier = (float)(end.Barrier - start.Barrier);
+		return result;
+	}
+
+	/* Cumulative sums at the given sample. O(1). */
+	inline Entry_t SampleAt(size_t aIndex) const
+	{
+		if (aIndex < this->Samples.size())  { return this->Samples[aIndex]; }
+		if (this->IsFinalized)              { return this->Total; }
+		if (!this->Samples.empty())         { return this->Samples.back(); }
+
+		return Entry_t{};
+	}
+
+	/* Cumulative sums of all events before aTime. O(1) on interval boundaries,
+	 * otherwise O(log n) in the distinct event times of the interval. */
+	inline Entry_t Prefix(uint32_t aTime) const
+	{
+		if (aTime > this->Total.Time || this->Samples.empty()) { return this->Total; }
+
+		/* A sample exists for every boundary up to the latest event. */
+		size_t  sample = aTime / TIMEINDEX_SAMPLE_INTERVAL;
+		Entry_t result = this->Samples[sample];
+
+		if (aTime % TIMEINDEX_SAMPLE_INTERVAL == 0) { return result; }
+
+		auto first = this->Points.begin() + result.Position;
+		auto last  = sample + 1 < this->Samples.size() ? this->Points.begin() + this->Samples[sample + 1].Position : this->Points.end();
+
+		/* The latest point before aTime holds the interval's sums up to there. */
+		auto next = std::lower_bound(first, last, aTime, [](const Point_t& aPoint, uint32_t aTime)
+		{
+			return aPoint.Time < aTime;
+		});
+
+		if (next != first)
+		{
+			const Point_t& point = *(next - 1);
+			result.Damage  += point.Damage;
+			result.Heal    += point.Heal;
+			result.Barrier += point.Barrier;
+		}
+
+		result.Time = aTime;
+
+		return result;
+	}
+
+	/* Pushes a sample for every interval boundary up to and including aTime. */
+	inline void SampleUntil(uint32_t aTime)
+	{
+		Entry_t current  = this->Total;
+		current.Position = (uint32_t)this->Points.size();
+
+		for (uint64_t boundary = (uint64_t)this->Samples.size() * TIMEINDEX_SAMPLE_INTERVAL; boundary <= aTime; boundary += TIMEINDEX_SAMPLE_INTERVAL)
+		{
+			current.Time = (uint32_t)boundary;
+			this->Samples.push_back(current);
+		}
+	}
+};
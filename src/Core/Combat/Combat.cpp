@@ -1,9 +1,12 @@
 #include "Combat.h"
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <ctime>
+#include <memory>
 #include <mutex>
+#include <new>
 #include <string>
 
 #include "GW2RE/Game/Agent/Agent.h"
@@ -23,10 +26,21 @@
 #include "GW2RE/Game/Text/TextApi.h"
 #include "GW2RE/Util/Hook.h"
 #include "memtools/memtools.h"
-#include "Targets.h"
+#include "Species.h"
 
 #include "CbtEncounter.h"
+#include "CbtEventFeed.h"
+#include "CbtEventLog.h"
+#include "LiveFeed.h"
 #include "Core/Addon.h"
+#include "Core/FlatMap.h"
+#include "Core/Format.h"
+#include "Core/HistoryIndex.h"
+#include "Core/PersonalBest.h"
+#include "Core/Profiler.h"
+#include "Core/Settings.h"
+#include "Core/SigCache.h"
+#include "Core/SpeciesTable.h"
 #include "UI/UiRoot.h"
 #include "Util/src/Strings.h"
 #include "Util/src/Time.h"
@@ -36,6 +50,21 @@ FUNC_HOOKREMOVE  HookRemove  = nullptr;
 FUNC_HOOKENABLE  HookEnable  = nullptr;
 FUNC_HOOKDISABLE HookDisable = nullptr;
 
+/* Interval in ms at which the character's combat state is polled. */
+#define COMBAT_POLL_INTERVAL 100
+
+/* Interval in ms at which the squad table is republished. */
+#define SQUAD_PUBLISH_INTERVAL 500
+
+/* Interval in ms at which the shared live feed is republished. */
+#define LIVEFEED_PUBLISH_INTERVAL 100
+
+/* Interval in ms at which the memory usage of the running encounter is sampled. */
+#define MEMORY_SAMPLE_INTERVAL 1000
+
+/* Interval in ms at which the master of a known non-player character is read again. */
+#define OWNER_CHECK_INTERVAL 1000
+
 namespace Combat
 {
 	static AddonAPI_t*                               s_APIDefs           = nullptr;
@@ -47,11 +76,53 @@ namespace Combat
 	static GW2RE::CAgent                             s_SelfAgent         = nullptr;
 	static Encounter_t*                              s_ActiveEncounter   = nullptr;
 
+	enum class ECombatState
+	{
+		Idle,     // No encounter, nothing is polled.
+		InCombat, // Encounter running, character in combat.
+		Grace,    // Out of combat inside an instance, waiting for the grace period.
+		Ended     // Encounter is finished and will be closed.
+	};
+
+	static std::atomic<ECombatState>                 s_State             = ECombatState::Idle;
+	static std::atomic<uint64_t>                     s_LastEventTick     = 0; // tick of the last stored combat event
+	static uint64_t                                  s_LastPollTick      = 0;
+	static uint32_t                                  s_MapID             = 0; // map the encounter started on
+
+	static RecapRing_t                               s_IncomingHits;                // latest hits on self for the death recap
+
+	static GW2RE::Agent_t*                           s_OwnedAgentsSelf   = nullptr; // self agent the owned set belongs to
+	static FlatMap_t<bool>                           s_OwnedAgents;                 // agent IDs known to be owned by self
+
+	static LiveFeed_t*                               s_LiveFeed          = nullptr; // shared through DataLink
+	static uint64_t                                  s_LiveFeedTime      = 0;       // event time of the last publish
+	static uint64_t                                  s_MemorySampleTime  = 0;       // event time of the last memory sample
+
+	/* Buffs on self while no encounter runs, carried into the next encounter. */
+	struct PrepullBuff_t
+	{
+		GW2RE::SkillDef_t* SkillDef;
+		BuffUptime_t       Uptime;
+	};
+
+	static GW2RE::Agent_t*                           s_PrepullSelf       = nullptr; // self agent the pre-pull buffs belong to
+	static uint64_t                                  s_PrepullStart      = 0;       // time the pre-pull buffs are relative to
+	static FlatMap_t<PrepullBuff_t*>                 s_PrepullBuffs;
+
 	/* Forward declare internal functions. */
 	Agent_t* TrackAgent(GW2RE::Agent_t* aAgent);
+	void UpdateOwner(Agent_t* aAgent, GW2RE::CCharacter& aCharacter);
 	Skill_t* TrackSkill(GW2RE::SkillDef_t* aSkill);
 	uint64_t __fastcall OnCombatEvent(GW2RE::CbtEvent_t*, uint32_t*);
+	void ProcessCombatEvent(GW2RE::CbtEvent_t*);
+	void ProcessBuffEvent(GW2RE::CCbtEv&);
+	void TrackPrepullBuff(GW2RE::CCbtEv&);
+	void CarryPrepullBuffs();
+	void ClearPrepullBuffs();
+	bool IsRelevant(GW2RE::CCbtEv&, ECombatEventType, GW2RE::Agent_t*);
+	bool IsOwnedBySelf(GW2RE::Agent_t*, GW2RE::Agent_t*);
 	void CombatEnd();
+	void PublishLiveFeed(bool);
 	void __fastcall Advance(void*, void*);
 
 	/* Text API */
@@ -71,20 +142,29 @@ void Combat::Create(AddonAPI_t* aApi)
 	/* Get system time offset for combat events. */
 	s_BootTime = (std::time(nullptr) * 1000) - GetTickCount64();
 
+	/* Live feed for other addons, the header is set once before the first publish. */
+	if (void* shared = s_APIDefs->DataLink_Share(DL_CMX_LIVE, sizeof(LiveFeed_t)))
+	{
+		s_LiveFeed = new (shared) LiveFeed_t();
+		s_LiveFeed->Version = CMX_LIVE_VERSION;
+		s_LiveFeed->Size    = sizeof(LiveFeed_t);
+	}
+
 	/* Set auxillary functions for Hook struct. */
 	HookCreate = (FUNC_HOOKCREATE)s_APIDefs->MinHook_Create;
 	HookRemove = (FUNC_HOOKREMOVE)s_APIDefs->MinHook_Remove;
 	HookEnable = (FUNC_HOOKENABLE)s_APIDefs->MinHook_Enable;
 	HookDisable = (FUNC_HOOKDISABLE)s_APIDefs->MinHook_Disable;
 
-	s_ResolveHash = GW2RE::S_ResolveTextHash.Scan<FN_RESOLVEHASH>();
-	s_DecodeText = GW2RE::S_DecodeText.Scan<FN_DECODETEXT>();
+	/* Cached offsets skip the scans. GW2RE scans are not known to be thread-safe, they run one after another. */
+	s_ResolveHash = SigCache::Resolve<FN_RESOLVEHASH>("ResolveTextHash", [] { return GW2RE::S_ResolveTextHash.Scan<FN_RESOLVEHASH>(); });
+	s_DecodeText = SigCache::Resolve<FN_DECODETEXT>("DecodeText", [] { return GW2RE::S_DecodeText.Scan<FN_DECODETEXT>(); });
 
-	FN_COMBATTRACKER cbttracker = GW2RE::S_FnCombatTracker.Scan<FN_COMBATTRACKER>();
+	FN_COMBATTRACKER cbttracker = SigCache::Resolve<FN_COMBATTRACKER>("FnCombatTracker", [] { return GW2RE::S_FnCombatTracker.Scan<FN_COMBATTRACKER>(); });
 
 	if (!cbttracker)
 	{
-		cbttracker = GW2RE::S_FnCombatTracker_Callsite.Scan<FN_COMBATTRACKER>();
+		cbttracker = SigCache::Resolve<FN_COMBATTRACKER>("FnCombatTracker_Callsite", [] { return GW2RE::S_FnCombatTracker_Callsite.Scan<FN_COMBATTRACKER>(); });
 
 		if (!cbttracker)
 		{
@@ -97,6 +177,11 @@ void Combat::Create(AddonAPI_t* aApi)
 		}
 	}
 
+	SigCache::Save();
+
+	EventSpill::Create(s_APIDefs->Paths_GetAddonDirectory("CombatMetrics/spill"));
+	EventFeed::Create(s_APIDefs);
+
 	GW2RE::CEventApi::Register(GW2RE::EEngineEvent::EngineTick, Advance);
 
 	s_HookCombatTracker = new GW2RE::Hook<FN_COMBATTRACKER>(cbttracker, OnCombatEvent);
@@ -110,6 +195,11 @@ void Combat::Destroy()
 	GW2RE::CEventApi::Deregister(GW2RE::EEngineEvent::EngineTick, Advance);
 
 	if (s_HookCombatTracker) { GW2RE::DestroyHook(s_HookCombatTracker); }
+
+	EventSpill::Destroy();
+	EventFeed::Destroy();
+
+	ClearPrepullBuffs();
 }
 
 bool Combat::IsRegistered()
@@ -132,47 +222,59 @@ Agent_t* Combat::TrackAgent(GW2RE::Agent_t* aAgent)
 	if (!aAgent)     { return nullptr; }
 	if (!aAgent->ID) { return nullptr; }
 
-	auto it = s_ActiveEncounter->Agents.find(aAgent->ID);
+	Agent_t* agent = s_ActiveEncounter->Agents.Get(aAgent->ID);
 
-	if (it != s_ActiveEncounter->Agents.end()) { return it->second; }
-	
-	it = s_ActiveEncounter->Agents.emplace(aAgent->ID, new Agent_t()).first;
+	GW2RE::CAgent    ag        = aAgent;
+
+	/* Same ID but a different game agent means the ID was recycled, track it as a new agent. */
+	if (agent && agent->GameAgent == aAgent)
+	{
+		/* Masters may change mid-fight, only non-player characters have one. Bosses are
+		 * hit thousands of times a minute, the game memory is only read once in a while. */
+		if (agent->Type == EAgentType::Character && !agent->IsPlayer)
+		{
+			uint64_t now = GetTickCount64();
 
-	it->second->ID = aAgent->ID;
+			if (now - agent->OwnerCheck >= OWNER_CHECK_INTERVAL)
+			{
+				agent->OwnerCheck = now;
+
+				if (GW2RE::CCharacter character = ag.GetCharacter())
+				{
+					UpdateOwner(agent, character);
+				}
+			}
+		}
+
+		return agent;
+	}
+
+	agent = s_ActiveEncounter->AddAgent(aAgent->ID, aAgent);
 
-	GW2RE::CAgent    ag        = aAgent;
 	GW2RE::CodedText codedName = nullptr;
 
 	switch (ag.GetType())
 	{
 		case GW2RE::EAgentType::Char:
 		{
-			it->second->Type = EAgentType::Character;
+			agent->Type = EAgentType::Character;
 
 			GW2RE::CCharacter character = ag.GetCharacter();
-			it->second->SpeciesID = character->SpeciesDef->ID;
+			agent->SpeciesID = character->SpeciesDef->ID;
 
 			if (character.IsPlayer())
 			{
+				agent->IsPlayer = true;
+
 				GW2RE::CPlayer player = character.GetPlayer();
 
 				/* No need for decoding, can grab raw text. */
-				strcpy_s(it->second->Name, sizeof(it->second->Name), String::ToString(player.GetName()).c_str());
+				strcpy_s(agent->Name, sizeof(agent->Name), String::ToString(player.GetName()).c_str());
 			}
 			else
 			{
-				GW2RE::CCharacter master = character.GetMaster();
-
-				while (master)
-				{
-					/* Recursive track master agent. */
-					TrackAgent(master.GetAgent());
-
-					it->second->IsMinion = true;
-					it->second->OwnerID = master.GetAgentId();
-
-					master = master.GetMaster(); // Go up the foodchain
-				}
+				agent->OwnerCheck = GetTickCount64();
+				UpdateOwner(agent, character);
 			}
 
 			codedName = character.GetCodedName();
@@ -180,39 +282,63 @@ Agent_t* Combat::TrackAgent(GW2RE::Agent_t* aAgent)
 		}
 		case GW2RE::EAgentType::Gadget:
 		{
-			it->second->Type = EAgentType::Gadget;
+			agent->Type = EAgentType::Gadget;
 
 			GW2RE::CGadget gadget = ag.GetGadget();
-			it->second->SpeciesID = gadget.GetArcID();
-
-			if (gadget->Flags & 1)
-			{
-				it->second->IsMinion = true;
-				it->second->OwnerID = s_ActiveEncounter->Self->ID;
-			}
+			agent->SpeciesID = gadget.GetArcID();
 
+			/* Gadgets expose no owner, they stay unowned rather than being credited to the wrong player. */
 			codedName = gadget.GetCodedName();
 			break;
 		}
 		case GW2RE::EAgentType::Gadget_Attack_Target:
 		{
-			it->second->Type = EAgentType::AttackTarget;
+			agent->Type = EAgentType::AttackTarget;
 
 			GW2RE::CGadgetAttackTarget at = ag.GetGadgetAttackTarget();
 			GW2RE::CGadget owner = at.GetOwner();
-			it->second->SpeciesID = owner.GetArcID();
+			agent->SpeciesID = owner.GetArcID();
 
 			codedName = owner.GetCodedName();
 			break;
 		}
 	}
 
-	if (codedName)
+	/* Resolved once per agent, the ingest only reads the flags. */
 	{
-		s_DecodeText(codedName, ReceiveText, &it->second->Name[0]);
+		SpeciesTable::Reader_t reader;
+		const SpeciesInfo_t* species = agent->IsPlayer ? nullptr : reader.Find(agent->SpeciesID);
+		agent->IsTarget  = species != nullptr;
+		agent->IsPrimary = species && species->Role == ESpeciesRole::Primary;
+
+		/* Agents keep the localized game name, the species name only names the encounter until it is decoded. */
+		if (codedName)
+		{
+			s_DecodeText(codedName, ReceiveText, &agent->Name[0]);
+		}
 	}
 
-	return it->second;
+	return agent;
+}
+
+void Combat::UpdateOwner(Agent_t* aAgent, GW2RE::CCharacter& aCharacter)
+{
+	GW2RE::CCharacter master = aCharacter.GetMaster();
+
+	uint32_t masterID = master ? master.GetAgentId() : 0;
+
+	if (masterID == aAgent->OwnerID) { return; }
+
+	bool isChange = aAgent->OwnerID != 0;
+
+	/* Tracking the direct master resolves its own chain, the root is inherited from it. */
+	s_ActiveEncounter->SetOwner(aAgent, master ? TrackAgent(master.GetAgent()) : nullptr);
+
+	/* The relevance filter may still cache the previous owner, it is rebuilt on demand. */
+	if (isChange)
+	{
+		s_OwnedAgents.Clear();
+	}
 }
 
 Skill_t* Combat::TrackSkill(GW2RE::SkillDef_t* aSkill)
@@ -221,21 +347,32 @@ Skill_t* Combat::TrackSkill(GW2RE::SkillDef_t* aSkill)
 	if (!aSkill->ID)   { return nullptr; }
 	if (!aSkill->Name) { return nullptr; }
 
-	auto it = s_ActiveEncounter->Skills.find(aSkill->ID);
+	Skill_t* skill = s_ActiveEncounter->Skills.Get(aSkill->ID);
 
-	if (it != s_ActiveEncounter->Skills.end()) { return it->second; }
+	if (skill) { return skill; }
 
-	it = s_ActiveEncounter->Skills.emplace(aSkill->ID, new Skill_t()).first;
+	skill = new Skill_t();
+	skill->ID = aSkill->ID;
 
-	it->second->ID = aSkill->ID;
+	s_ActiveEncounter->Skills.Set(aSkill->ID, skill);
 
 	GW2RE::CodedText codedText = s_ResolveHash(aSkill->Name, GW2RE::ETextOperation::Terminate);
-	s_DecodeText(codedText, ReceiveText, &it->second->Name);
+	s_DecodeText(codedText, ReceiveText, &skill->Name);
 
-	return it->second;
+	return skill;
 }
 
 uint64_t __fastcall Combat::OnCombatEvent(GW2RE::CbtEvent_t* aCombatEvent, uint32_t* a2)
+{
+	{
+		PROFILE_SCOPE(Profiler::CombatEvent);
+		ProcessCombatEvent(aCombatEvent);
+	}
+
+	return s_HookCombatTracker->OriginalFunction(aCombatEvent, a2);
+}
+
+void Combat::ProcessCombatEvent(GW2RE::CbtEvent_t* aCombatEvent)
 {
 	const std::lock_guard<std::mutex> lock(s_HookCombatTracker->Mutex);
 
@@ -247,13 +384,13 @@ uint64_t __fastcall Combat::OnCombatEvent(GW2RE::CbtEvent_t* aCombatEvent, uint3
 	/* If no active map, or active map is PvP, do not process. */
 	if (!missionctx || (missionctx->CurrentMap && missionctx->CurrentMap->PvP))
 	{
-		return s_HookCombatTracker->OriginalFunction(aCombatEvent, a2);
+		return;
 	}
 
 	/* Filter display events. */
 	if (!aCbtEv || aCbtEv.IsDisplayedBuffDamage())
 	{
-		return s_HookCombatTracker->OriginalFunction(aCombatEvent, a2);
+		return;
 	}
 
 	/* Filter out unwanted events. */
@@ -275,14 +412,30 @@ uint64_t __fastcall Combat::OnCombatEvent(GW2RE::CbtEvent_t* aCombatEvent, uint3
 			evType = ECombatEventType::Health;
 			break;
 		}
+		case GW2RE::ECbtEventType::BuffApply:
+		case GW2RE::ECbtEventType::BuffRemove:
+		{
+			/* Buffs only accumulate uptime, they never start an encounter and are not stored. */
+			ProcessBuffEvent(aCbtEv);
+			return;
+		}
 
 		default:
 		{
 			/* Do not process other events. */
-			return s_HookCombatTracker->OriginalFunction(aCombatEvent, a2);
+			return;
 		}
 	}
 
+	/* Self agent is fixed for the duration of an encounter. */
+	GW2RE::CAgent self = s_ActiveEncounter ? s_SelfAgent : propctx.GetCharCliCtx().GetControlledAgent();
+
+	/* Reject events unrelated to the player before anything is tracked or allocated. */
+	if (Settings::CaptureMode == ECaptureMode::SelfOnly && !IsRelevant(aCbtEv, evType, self.ptr()))
+	{
+		return;
+	}
+
 	/* If no active encounter -> Combat entry. */
 	if (!s_ActiveEncounter)
 	{
@@ -290,214 +443,619 @@ uint64_t __fastcall Combat::OnCombatEvent(GW2RE::CbtEvent_t* aCombatEvent, uint3
 
 		s_ActiveEncounter = new Encounter_t();
 		s_ActiveEncounter->TimeStart = s_BootTime + aCbtEv->SysTime;
+		s_ActiveEncounter->CombatEvents.SpillEnabled = Settings::SpillToDisk;
+		s_ActiveEncounter->CombatEvents.SpillPath = EventSpill::GetSpillPath();
+		s_ActiveEncounter->BindTimeIndices();
+
+		/* Keep self agent for reference. */
+		s_SelfAgent = self;
+		s_ActiveEncounter->Self = TrackAgent(self.ptr());
 
-		/* Grab self agent for reference. */
-		GW2RE::CPropContext    propctx = GW2RE::CPropContext::Get();
-		GW2RE::CCharCliContext cctx    = propctx.GetCharCliCtx();
-		GW2RE::CAgent          agent   = cctx.GetControlledAgent();
+		CarryPrepullBuffs();
 
-		s_SelfAgent = agent;
-		s_ActiveEncounter->Self = TrackAgent(agent.ptr());
+		s_MapID = missionctx->CurrentMapID;
+		s_State = ECombatState::InCombat;
+
+		s_IncomingHits.Clear();
 	}
 
-	/* Allocate and assign new internal event type. */
-	CombatEvent_t* ev = new CombatEvent_t();
-	ev->Type              = evType;
+	s_LastEventTick = GetTickCount64();
+
+	/* Assign new internal event type. */
+	CombatEvent_t event{};
+	event.Type              = evType;
 
-	ev->Time              = s_BootTime + aCbtEv->SysTime;
+	/* Events may arrive slightly out of order, none is placed before the encounter start. */
+	event.Time              = max(s_BootTime + aCbtEv->SysTime, s_ActiveEncounter->TimeStart);
 
-	ev->SrcAgent          = TrackAgent(aCbtEv->SrcAgent);
-	ev->DstAgent          = TrackAgent(aCbtEv->DstAgent);
-	ev->Skill             = TrackSkill(aCbtEv->SkillDef);
+	event.SrcAgent          = TrackAgent(aCbtEv->SrcAgent);
+	event.DstAgent          = TrackAgent(aCbtEv->DstAgent);
+	event.Skill             = TrackSkill(aCbtEv->SkillDef);
 
-	ev->Value             = aCbtEv->Value;
-	ev->ValueAlt          = aCbtEv->Value2;
+	event.Value             = aCbtEv->Value;
+	event.ValueAlt          = aCbtEv->Value2;
 
-	ev->IsConditionDamage = aCbtEv.IsConditionDamage();
-	ev->IsCritical        = aCbtEv.IsCritical();
-	ev->IsFumble          = aCbtEv.IsFumble();
+	event.IsConditionDamage = aCbtEv.IsConditionDamage();
+	event.IsCritical        = aCbtEv.IsCritical();
+	event.IsFumble          = aCbtEv.IsFumble();
+
+	/* Store combat event. */
+	CombatEvent_t* ev = s_ActiveEncounter->CombatEvents.Append(event);
 
 	/* End time is always combat event time. */
 	s_ActiveEncounter->TimeEnd = ev->Time;
 
-	/* Store combat event. */
-	s_ActiveEncounter->CombatEvents.push_back(ev);
+	if (!s_ActiveEncounter->FirstTarget && ev->SrcAgent == s_ActiveEncounter->Self && ev->DstAgent && ev->DstAgent != s_ActiveEncounter->Self)
+	{
+		s_ActiveEncounter->FirstTarget = ev->DstAgent;
+	}
 
-	/* Check for trigger ID. */
+	/* Check for trigger ID. The list holds species, the trigger is the agent. */
 	if (s_ActiveEncounter->TriggerID == 0)
 	{
-		if (ev->SrcAgent && ev->SrcAgent->ID)
+		if (ev->SrcAgent && ev->SrcAgent->ID && ev->SrcAgent->IsPrimary)
 		{
-			if (std::find(s_PrimaryTargets.begin(), s_PrimaryTargets.end(), ev->SrcAgent->ID) != s_PrimaryTargets.end())
-			{
-				s_ActiveEncounter->TriggerID = ev->SrcAgent->ID;
-			}
+			s_ActiveEncounter->TriggerID = ev->SrcAgent->ID;
 		}
-		else if (ev->DstAgent && ev->DstAgent->ID)
+		else if (ev->DstAgent && ev->DstAgent->ID && ev->DstAgent->IsPrimary)
+		{
+			s_ActiveEncounter->TriggerID = ev->DstAgent->ID;
+		}
+
+		if (s_ActiveEncounter->TriggerID)
 		{
-			if (std::find(s_PrimaryTargets.begin(), s_PrimaryTargets.end(), ev->DstAgent->ID) != s_PrimaryTargets.end())
+			s_ActiveEncounter->SpeciesID = s_ActiveEncounter->Agents.Get(s_ActiveEncounter->TriggerID)->SpeciesID;
+
+			SpeciesTable::Reader_t reader;
+			const SpeciesInfo_t* species = reader.Find(s_ActiveEncounter->SpeciesID);
+			s_ActiveEncounter->Phases.Rule = species ? species->Phases : Species::DefaultPhaseRule;
+
+			if (species)
 			{
-				s_ActiveEncounter->TriggerID = ev->DstAgent->ID;
+				strcpy_s(s_ActiveEncounter->SpeciesName, sizeof(s_ActiveEncounter->SpeciesName), species->Name);
+				s_ActiveEncounter->Group = species->Group;
+				s_ActiveEncounter->IsCM  = species->IsCM;
 			}
+
+			/* Pacing curve is loaded in the background while the fight goes on. */
+			PersonalBest::Request(s_ActiveEncounter->SpeciesID);
 		}
 	}
 
 	/* Process stats. */
 	{
-		/*              hasSrc       &&  src is self                               ||  src is owned minion */
-		bool outgoing = ev->SrcAgent && ((ev->SrcAgent == s_ActiveEncounter->Self) || (ev->SrcAgent->OwnerID == s_ActiveEncounter->Self->ID));
+		/* Self and everything it summoned share self as root. */
+		bool outgoing = s_ActiveEncounter->IsOwnedBySelf(ev->SrcAgent);
 		bool incoming = ev->DstAgent && ev->DstAgent == s_ActiveEncounter->Self;
 
+		Stats_t delta = ClassifyEvent(*ev);
+
+		/* Time relative to encounter start for the time index, never negative, see above. */
+		uint32_t relTime = (uint32_t)(ev->Time - s_ActiveEncounter->TimeStart);
+
 		if (outgoing && ev->DstAgent)
 		{
-			bool isTarget = std::find(s_PrimaryTargets.begin(), s_PrimaryTargets.end(), ev->DstAgent->SpeciesID) != s_PrimaryTargets.end()
-				|| std::find(s_SecondaryTargets.begin(), s_SecondaryTargets.end(), ev->DstAgent->SpeciesID) != s_SecondaryTargets.end();
+			bool isTarget = ev->DstAgent->IsTarget;
 
-			if (ev->Value < 0)
-			{
-				/* Damage */
-
-				s_ActiveEncounter->OutCleave.Damage += ev->Value;
+			s_ActiveEncounter->OutCleave.Accept(*ev, delta);
 
-				if (isTarget)
-				{
-					s_ActiveEncounter->OutTarget.Damage += ev->Value;
-				}
-			}
-			else if (ev->Value > 0)
+			if (ev->Skill)
 			{
-				/* Heal */
-				s_ActiveEncounter->OutCleave.Heal += ev->Value;
-
-				if (isTarget)
-				{
-					s_ActiveEncounter->OutTarget.Heal += ev->Value;
-				}
+				ev->Skill->Out.Accept(*ev, delta);
 			}
-			else if (ev->ValueAlt > 0)
+			s_ActiveEncounter->OutCleaveIndex.Add(*ev, relTime, delta);
+
+			if (isTarget)
 			{
-				/* Barrier */
-				s_ActiveEncounter->OutCleave.Barrier += ev->ValueAlt;
+				s_ActiveEncounter->OutTarget.Accept(*ev, delta);
+				s_ActiveEncounter->OutTargetIndex.Add(*ev, relTime, delta);
+			}
 
-				if (isTarget)
-				{
-					s_ActiveEncounter->OutTarget.Barrier += ev->ValueAlt;
-				}
+			s_ActiveEncounter->Phases.OnOutgoing(relTime, ev->DstAgent->SpeciesID, isTarget, delta);
+
+			if (delta.Damage < 0.f)
+			{
+				s_ActiveEncounter->Activity.OnHit(relTime);
 			}
 		}
 		else if (incoming && ev->SrcAgent)
 		{
-			bool isTarget = std::find(s_PrimaryTargets.begin(), s_PrimaryTargets.end(), ev->SrcAgent->SpeciesID) != s_PrimaryTargets.end()
-				|| std::find(s_SecondaryTargets.begin(), s_SecondaryTargets.end(), ev->SrcAgent->SpeciesID) != s_SecondaryTargets.end();
+			bool isTarget = ev->SrcAgent->IsTarget;
 
-			if (ev->Value < 0)
+			s_ActiveEncounter->InCleave.Accept(*ev, delta);
+			s_ActiveEncounter->InCleaveIndex.Add(*ev, relTime, delta);
+
+			if (isTarget)
 			{
-				/* Damage */
+				s_ActiveEncounter->InTarget.Accept(*ev, delta);
+				s_ActiveEncounter->InTargetIndex.Add(*ev, relTime, delta);
+			}
 
-				s_ActiveEncounter->InCleave.Damage += ev->Value;
+			s_ActiveEncounter->Phases.OnIncoming(relTime, isTarget, delta);
 
-				if (isTarget)
-				{
-					s_ActiveEncounter->InTarget.Damage += ev->Value;
-				}
-			}
-			else if (ev->Value > 0)
+			if (delta.Damage < 0.f)
 			{
-				/* Heal */
-				s_ActiveEncounter->InCleave.Heal += ev->Value;
-
-				if (isTarget)
-				{
-					s_ActiveEncounter->InTarget.Heal += ev->Value;
-				}
+				s_IncomingHits.Push(RecapHit_t{ ev->Time, ev->SrcAgent, ev->Skill, delta.Damage });
 			}
-			else if (ev->ValueAlt > 0)
+		}
+
+		s_ActiveEncounter->TrackStates(*ev, relTime);
+
+		/* Freeze the incoming hits leading up to going down or dying. */
+		if ((ev->Type == ECombatEventType::Down || ev->Type == ECombatEventType::Death) && ev->DstAgent == s_ActiveEncounter->Self)
+		{
+			auto recap = std::make_shared<DeathRecap_t>();
+			s_IncomingHits.Freeze(*recap, ev->Type, ev->Time);
+
+			std::atomic_store(&s_ActiveEncounter->Recap, std::shared_ptr<const DeathRecap_t>(recap));
+		}
+
+		if (ev->Type == ECombatEventType::Down && ev->DstAgent && ev->DstAgent->IsTarget)
+		{
+			s_ActiveEncounter->Phases.OnTargetDown(relTime, ev->DstAgent->ID);
+		}
+
+		if (ev->Type == ECombatEventType::Death && ev->DstAgent && ev->DstAgent != s_ActiveEncounter->Self)
+		{
+			bool isTarget = ev->DstAgent->IsTarget;
+
+			if (isTarget)
 			{
-				/* Barrier */
-				s_ActiveEncounter->InCleave.Barrier += ev->ValueAlt;
+				s_ActiveEncounter->Phases.OnTargetDeath(relTime, ev->DstAgent->ID);
+			}
 
-				if (isTarget)
-				{
-					s_ActiveEncounter->InTarget.Barrier += ev->ValueAlt;
-				}
+			if (ev->DstAgent->ID == s_ActiveEncounter->TriggerID)
+			{
+				s_ActiveEncounter->IsKill = true;
 			}
 		}
+
+		/* Squad mode attributes to the root of the source, no lookups needed. */
+		if (Settings::CaptureMode == ECaptureMode::Squad && !delta.IsEmpty() && ev->SrcAgent && ev->DstAgent)
+		{
+			s_ActiveEncounter->AccumulateSquad(*ev, delta, SQUAD_PUBLISH_INTERVAL);
+		}
+
+		if (EventFeed::HasSubscribers())
+		{
+			EventFeed::Push(*ev, (outgoing ? EVENTRECORD_FLAG_OUTGOING : 0) | (incoming ? EVENTRECORD_FLAG_INCOMING : 0));
+		}
+	}
+
+	if (ev->Time - s_LiveFeedTime >= LIVEFEED_PUBLISH_INTERVAL)
+	{
+		PublishLiveFeed(true);
+	}
+
+	/* The budget also holds during long encounters, older encounters make room. */
+	if (ev->Time - s_MemorySampleTime >= MEMORY_SAMPLE_INTERVAL)
+	{
+		s_ActiveEncounter->MemoryUsage.store(s_ActiveEncounter->GetMemoryUsage(), std::memory_order_relaxed);
+		s_MemorySampleTime = ev->Time;
+
+		UiRoot::OnMemoryUsage();
 	}
 
 	s_APIDefs->Events_RaiseNotificationTargeted(ADDON_SIG, EV_CMX_COMBAT);
 	
-	s_APIDefs->Log(
-		LOGL_DEBUG,
-		ADDON_NAME,
-		String::Format(
-			"[EV:%u] <c=#00ff00>%s</c> (%u) hits <c=#ff0000>%s</c> (%u) using <c=#0000ff>%s</c> (%u) with %.0f (%.0f).",
-			ev->Type,
-			ev->SrcAgent ? ev->SrcAgent->GetName().c_str() : "(null)",
-			ev->SrcAgent ? ev->SrcAgent->ID : 0,
-			ev->DstAgent ? ev->DstAgent->GetName().c_str() : "(null)",
-			ev->DstAgent ? ev->DstAgent->ID : 0,
-			ev->Skill ? ev->Skill->GetName().c_str() : "(null)",
-			ev->Skill ? ev->Skill->ID : 0,
-			ev->Value,
-			ev->ValueAlt
-		).c_str()
-	);
+	/* Built on the stack, this runs for every event. */
+	char srcName[32];
+	char dstName[32];
+	char skillName[32];
+	char trace[512];
+	size_t length = 0;
+	trace[0] = '\0';
+
+	Format::Append(trace, sizeof(trace), length, "[EV:");
+	Format::AppendInteger(trace, sizeof(trace), length, (uint64_t)ev->Type);
+	Format::Append(trace, sizeof(trace), length, "] <c=#00ff00>");
+	Format::Append(trace, sizeof(trace), length, ev->SrcAgent ? ev->SrcAgent->GetName(srcName, sizeof(srcName)) : "(null)");
+	Format::Append(trace, sizeof(trace), length, "</c> (");
+	Format::AppendInteger(trace, sizeof(trace), length, ev->SrcAgent ? ev->SrcAgent->ID : 0);
+	Format::Append(trace, sizeof(trace), length, ") hits <c=#ff0000>");
+	Format::Append(trace, sizeof(trace), length, ev->DstAgent ? ev->DstAgent->GetName(dstName, sizeof(dstName)) : "(null)");
+	Format::Append(trace, sizeof(trace), length, "</c> (");
+	Format::AppendInteger(trace, sizeof(trace), length, ev->DstAgent ? ev->DstAgent->ID : 0);
+	Format::Append(trace, sizeof(trace), length, ") using <c=#0000ff>");
+	Format::Append(trace, sizeof(trace), length, ev->Skill ? ev->Skill->GetName(skillName, sizeof(skillName)) : "(null)");
+	Format::Append(trace, sizeof(trace), length, "</c> (");
+	Format::AppendInteger(trace, sizeof(trace), length, ev->Skill ? ev->Skill->ID : 0);
+	Format::Append(trace, sizeof(trace), length, ") with ");
+	Format::AppendNumber(trace, sizeof(trace), length, ev->Value, 0);
+	Format::Append(trace, sizeof(trace), length, " (");
+	Format::AppendNumber(trace, sizeof(trace), length, ev->ValueAlt, 0);
+	Format::Append(trace, sizeof(trace), length, ").");
+
+	s_APIDefs->Log(LOGL_DEBUG, ADDON_NAME, trace);
+}
 
-	return s_HookCombatTracker->OriginalFunction(aCombatEvent, a2);
+void Combat::ProcessBuffEvent(GW2RE::CCbtEv& aCbtEv)
+{
+	if (!aCbtEv->DstAgent)                          { return; }
+	if (!aCbtEv->SkillDef || !aCbtEv->SkillDef->ID) { return; }
+
+	/* Boons applied before the pull are kept for the encounter that follows. */
+	if (!s_ActiveEncounter)
+	{
+		TrackPrepullBuff(aCbtEv);
+		return;
+	}
+
+	/* Only self and the trigger are of interest, everything else is dropped before any lookup. */
+	FlatMap_t<BuffUptime_t*>* buffs = nullptr;
+
+	if (aCbtEv->DstAgent == s_SelfAgent.ptr())
+	{
+		buffs = &s_ActiveEncounter->BuffsSelf;
+	}
+	else if (Agent_t* trigger = s_ActiveEncounter->Agents.Get(s_ActiveEncounter->TriggerID))
+	{
+		if (trigger->GameAgent == aCbtEv->DstAgent)
+		{
+			buffs = &s_ActiveEncounter->BuffsTarget;
+		}
+	}
+
+	if (!buffs) { return; }
+
+	uint64_t time = s_BootTime + aCbtEv->SysTime;
+
+	if (time < s_ActiveEncounter->TimeStart) { return; }
+
+	uint32_t relTime = (uint32_t)(time - s_ActiveEncounter->TimeStart);
+
+	BuffUptime_t* uptime = buffs->Get(aCbtEv->SkillDef->ID);
+
+	if (!uptime)
+	{
+		uptime = new BuffUptime_t();
+		uptime->Buff       = TrackSkill(aCbtEv->SkillDef);
+		uptime->Stacking   = Buffs::GetStacking(aCbtEv->SkillDef->ID);
+
+		if (uptime->Buff) { uptime->Buff->IsBuff = true; }
+		uptime->LastChange = relTime;
+		buffs->Set(aCbtEv->SkillDef->ID, uptime);
+	}
+
+	/* Value of an application is its duration in ms. */
+	if (aCbtEv->EventType == GW2RE::ECbtEventType::BuffApply)
+	{
+		uptime->Apply(relTime, (uint32_t)aCbtEv->Value);
+	}
+	else
+	{
+		uptime->Remove(relTime);
+	}
+}
+
+void Combat::TrackPrepullBuff(GW2RE::CCbtEv& aCbtEv)
+{
+	GW2RE::Agent_t* self = GW2RE::CPropContext::Get().GetCharCliCtx().GetControlledAgent().ptr();
+
+	if (!self || aCbtEv->DstAgent != self) { return; }
+
+	/* Another character or a map change, the buffs of the old agent no longer apply. */
+	if (self != s_PrepullSelf)
+	{
+		ClearPrepullBuffs();
+		s_PrepullSelf = self;
+	}
+
+	uint64_t time = s_BootTime + aCbtEv->SysTime;
+
+	if (s_PrepullBuffs.Size() == 0) { s_PrepullStart = time; }
+
+	if (time < s_PrepullStart) { return; }
+
+	uint32_t relTime = (uint32_t)(time - s_PrepullStart);
+
+	PrepullBuff_t* buff = s_PrepullBuffs.Get(aCbtEv->SkillDef->ID);
+
+	if (!buff)
+	{
+		buff = new PrepullBuff_t{ aCbtEv->SkillDef, {} };
+		buff->Uptime.Stacking   = Buffs::GetStacking(aCbtEv->SkillDef->ID);
+		buff->Uptime.LastChange = relTime;
+		s_PrepullBuffs.Set(aCbtEv->SkillDef->ID, buff);
+	}
+
+	if (aCbtEv->EventType == GW2RE::ECbtEventType::BuffApply)
+	{
+		buff->Uptime.Apply(relTime, (uint32_t)aCbtEv->Value);
+	}
+	else
+	{
+		buff->Uptime.Remove(relTime);
+	}
+}
+
+void Combat::CarryPrepullBuffs()
+{
+	if (s_PrepullSelf == s_SelfAgent.ptr() && s_ActiveEncounter->TimeStart >= s_PrepullStart)
+	{
+		uint32_t offset = (uint32_t)(s_ActiveEncounter->TimeStart - s_PrepullStart);
+
+		s_PrepullBuffs.ForEach([offset](uint32_t aID, PrepullBuff_t* aBuff)
+		{
+			aBuff->Uptime.Advance(offset);
+
+			if (aBuff->Uptime.Expiries.empty()) { return; }
+
+			BuffUptime_t* uptime = new BuffUptime_t();
+			uptime->Carry(aBuff->Uptime, offset);
+			uptime->Buff = TrackSkill(aBuff->SkillDef);
+
+			if (uptime->Buff) { uptime->Buff->IsBuff = true; }
+			s_ActiveEncounter->BuffsSelf.Set(aID, uptime);
+		});
+	}
+
+	ClearPrepullBuffs();
+}
+
+void Combat::ClearPrepullBuffs()
+{
+	s_PrepullBuffs.ForEach([](uint32_t, PrepullBuff_t* aBuff)
+	{
+		delete aBuff;
+	});
+
+	s_PrepullBuffs.Clear();
+	s_PrepullSelf = nullptr;
+}
+
+bool Combat::IsRelevant(GW2RE::CCbtEv& aCbtEv, ECombatEventType aType, GW2RE::Agent_t* aSelf)
+{
+	if (!aSelf) { return false; }
+
+	GW2RE::Agent_t* src = aCbtEv->SrcAgent;
+	GW2RE::Agent_t* dst = aCbtEv->DstAgent;
+
+	/* Outgoing from or incoming on self. */
+	if (src == aSelf || dst == aSelf) { return true; }
+
+	/* Outgoing from an owned minion. */
+	if (src && src->ID && IsOwnedBySelf(src, aSelf)) { return true; }
+
+	/* State changes of agents already part of the encounter, e.g. a target dying. */
+	if (aType != ECombatEventType::Health && s_ActiveEncounter && dst && dst->ID)
+	{
+		return s_ActiveEncounter->Agents.Get(dst->ID) != nullptr;
+	}
+
+	return false;
+}
+
+bool Combat::IsOwnedBySelf(GW2RE::Agent_t* aAgent, GW2RE::Agent_t* aSelf)
+{
+	/* Owned agents are only valid for the self agent they were collected for. */
+	if (s_OwnedAgentsSelf != aSelf)
+	{
+		s_OwnedAgents.Clear();
+		s_OwnedAgentsSelf = aSelf;
+	}
+
+	if (s_OwnedAgents.Get(aAgent->ID)) { return true; }
+
+	/* Not cached, walk the masters. This does not allocate, so unowned agents are not cached. */
+	bool isOwned = false;
+
+	GW2RE::CAgent ag = aAgent;
+
+	switch (ag.GetType())
+	{
+		case GW2RE::EAgentType::Char:
+		{
+			GW2RE::CCharacter master = ag.GetCharacter().GetMaster();
+
+			while (master && !isOwned)
+			{
+				isOwned = master.GetAgentId() == aSelf->ID;
+				master = master.GetMaster();
+			}
+			break;
+		}
+		default:
+		{
+			break;
+		}
+	}
+
+	if (isOwned)
+	{
+		s_OwnedAgents.Set(aAgent->ID, true);
+	}
+
+	return isOwned;
 }
 
 void Combat::CombatEnd()
 {
 	if (!s_ActiveEncounter) { return; }
 
+	const std::lock_guard<std::mutex> lock(s_HookCombatTracker->Mutex);
+
 	s_APIDefs->Log(LOGL_DEBUG, ADDON_NAME, "Combat end.");
 	s_SelfAgent = nullptr;
 
+	/* Agent IDs may be recycled between encounters. */
+	s_OwnedAgents.Clear();
+	s_OwnedAgentsSelf = nullptr;
+
+	/* Seal the time index, no more events will be added. */
+	uint32_t duration = (uint32_t)(s_ActiveEncounter->TimeEnd - s_ActiveEncounter->TimeStart);
+
+	for (FlatMap_t<BuffUptime_t*>* buffs : { &s_ActiveEncounter->BuffsSelf, &s_ActiveEncounter->BuffsTarget })
+	{
+		buffs->ForEach([duration](uint32_t, BuffUptime_t* aUptime)
+		{
+			aUptime->Finalize(duration);
+		});
+	}
+
+	s_ActiveEncounter->OutTargetIndex.Finalize(duration);
+	s_ActiveEncounter->OutCleaveIndex.Finalize(duration);
+	s_ActiveEncounter->InTargetIndex.Finalize(duration);
+	s_ActiveEncounter->InCleaveIndex.Finalize(duration);
+	s_ActiveEncounter->OutTarget.Finalize(duration);
+	s_ActiveEncounter->OutCleave.Finalize(duration);
+	s_ActiveEncounter->InTarget.Finalize(duration);
+	s_ActiveEncounter->InCleave.Finalize(duration);
+
+	s_ActiveEncounter->Skills.ForEach([duration](uint32_t, Skill_t* aSkill)
+	{
+		aSkill->Out.Finalize(duration);
+		s_ActiveEncounter->OutHits.Merge(aSkill->Out);
+	});
+	s_ActiveEncounter->OutHits.Finalize(duration);
+	s_ActiveEncounter->Phases.Finalize();
+	s_ActiveEncounter->Activity.Finalize();
+
+	if (!s_ActiveEncounter->AgentStats.empty())
+	{
+		s_ActiveEncounter->PublishSquad(s_ActiveEncounter->TimeEnd);
+	}
+
 	if (s_ActiveEncounter->TriggerID)
 	{
 		/* TODO: Write log. */
 	}
 
+	/* Kills are offered as personal best, the comparison and write happen in the background. */
+	if (s_ActiveEncounter->IsKill && s_ActiveEncounter->SpeciesID)
+	{
+		const std::vector<TimeIndex_t::Entry_t>& samples = s_ActiveEncounter->OutTargetIndex.Samples;
+
+		std::vector<float> curve;
+		curve.reserve(samples.size());
+
+		for (const TimeIndex_t::Entry_t& sample : samples)
+		{
+			curve.push_back((float)-sample.Damage);
+		}
+
+		PersonalBest::Submit(s_ActiveEncounter->SpeciesID, duration, std::move(curve));
+	}
+
+	PublishLiveFeed(false);
+
+	/* Sealed, the sample is final. */
+	s_ActiveEncounter->MemoryUsage.store(s_ActiveEncounter->GetMemoryUsage(), std::memory_order_relaxed);
+	s_MemorySampleTime = 0;
+
+	/* Encounters the UI drops are not worth searching for. */
+	if (duration >= 5000)
+	{
+		HistoryIndex::Add(s_ActiveEncounter);
+	}
+
 	s_ActiveEncounter = nullptr;
+	s_State = ECombatState::Idle;
 
 	UiRoot::OnCombatEnd();
 }
 
+void Combat::PublishLiveFeed(bool aIsActive)
+{
+	if (!s_LiveFeed) { return; }
+
+	auto toLive = [](const Stats_t& aStats)
+	{
+		return LiveStats_t{ aStats.Damage, aStats.Heal, aStats.Barrier };
+	};
+
+	uint32_t duration = (uint32_t)(s_ActiveEncounter->TimeEnd - s_ActiveEncounter->TimeStart);
+	uint32_t windowStart = duration > CMX_LIVE_ROLLING_WINDOW ? duration - CMX_LIVE_ROLLING_WINDOW : 0;
+
+	/* Starts on a sample boundary, the lookup on the ingest stays O(1). */
+	windowStart -= windowStart % TIMEINDEX_SAMPLE_INTERVAL;
+
+	uint32_t windowLength = duration - windowStart > 1000 ? duration - windowStart : 1000;
+
+	LiveFeedData_t data{};
+	data.IsActive   = aIsActive;
+	data.SpeciesID  = s_ActiveEncounter->SpeciesID;
+	data.TimeStart  = s_ActiveEncounter->TimeStart;
+	data.Duration   = duration;
+	data.RollingDPS = -s_ActiveEncounter->OutTargetIndex.Query(windowStart, duration).Damage / (windowLength / 1000.f);
+	data.OutTarget  = toLive(s_ActiveEncounter->OutTarget);
+	data.OutCleave  = toLive(s_ActiveEncounter->OutCleave);
+	data.InTarget   = toLive(s_ActiveEncounter->InTarget);
+	data.InCleave   = toLive(s_ActiveEncounter->InCleave);
+
+	s_LiveFeed->Write(data);
+	s_LiveFeedTime = s_ActiveEncounter->TimeEnd;
+}
+
 void __fastcall Combat::Advance(void*, void*)
 {
-	GW2RE::CPropContext      propctx    = GW2RE::CPropContext::Get();
-	GW2RE::CCharCliContext   cctx       = propctx.GetCharCliCtx();
-	GW2RE::CCharacter        character  = cctx.GetOwnedCharacter();
-	GW2RE::MissionContext_t* missionctx = propctx.GetMissionCtx();
+	PROFILE_SCOPE(Profiler::Advance);
 
-	static uint32_t s_LastMapID = 0;
+	/* Batches for event feed subscribers go out once per tick. */
+	EventFeed::Dispatch();
 
-	if (missionctx->CurrentMapID != s_LastMapID)
-	{
-		s_LastMapID = missionctx->CurrentMapID;
-		CombatEnd();
-	}
-	else if (!character)
-	{
-		CombatEnd();
-	}
-	else if (s_ActiveEncounter)
+	/* Nothing to poll until the first combat event arrives. */
+	if (s_State == ECombatState::Idle) { return; }
+
+	uint64_t now = GetTickCount64();
+
+	if (s_State != ECombatState::Ended)
 	{
-		bool isInCombat = (character->Flags & GW2RE::ECharacterFlags::IsInCombat) == GW2RE::ECharacterFlags::IsInCombat;
+		if (now - s_LastPollTick < COMBAT_POLL_INTERVAL) { return; }
+		s_LastPollTick = now;
+
+		GW2RE::CPropContext      propctx    = GW2RE::CPropContext::Get();
+		GW2RE::CCharCliContext   cctx       = propctx.GetCharCliCtx();
+		GW2RE::CCharacter        character  = cctx.GetOwnedCharacter();
+		GW2RE::MissionContext_t* missionctx = propctx.GetMissionCtx();
 
-		if (!isInCombat)
+		if (!missionctx || missionctx->CurrentMapID != s_MapID || !character)
+		{
+			/* Map change or character gone, always ends the encounter. */
+			s_State = ECombatState::Ended;
+		}
+		else
 		{
-			///* If instance, end combat after 15s of */
-			//if (missionctx->CurrentMap->Type == GW2RE::EMapType::Instance)
-			//{
-			//	uint64_t delta = std::time(nullptr) - (s_ActiveEncounter->TimeEnd / 1000);
-			//
-			//	/* If last combat event is longer than 15s ago. End combat. */
-			//	if (delta >= 15) { CombatEnd(); }
-			//}
-			CombatEnd();
+			bool isInCombat = (character->Flags & GW2RE::ECharacterFlags::IsInCombat) == GW2RE::ECharacterFlags::IsInCombat;
+			bool isInstance = missionctx->CurrentMap && missionctx->CurrentMap->Type == GW2RE::EMapType::Instance;
+
+			switch (s_State)
+			{
+				case ECombatState::InCombat:
+				{
+					if (!isInCombat)
+					{
+						s_State = isInstance && Settings::InstanceGracePeriod > 0
+							? ECombatState::Grace
+							: ECombatState::Ended;
+					}
+					break;
+				}
+				case ECombatState::Grace:
+				{
+					if (isInCombat)
+					{
+						s_State = ECombatState::InCombat;
+					}
+					else if (now - s_LastEventTick >= Settings::InstanceGracePeriod)
+					{
+						/* No combat events for the whole grace period. */
+						s_State = ECombatState::Ended;
+					}
+					break;
+				}
+				default:
+				{
+					break;
+				}
+			}
 		}
 	}
+
+	if (s_State == ECombatState::Ended)
+	{
+		CombatEnd();
+	}
 }
 
 void __fastcall Combat::ReceiveText(void* aPtr, const wchar_t* aWString)
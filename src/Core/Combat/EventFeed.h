@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+
+/* Processed combat events for other addons, delivered in batches once per
+ * tick. The function table is shared through DataLink; consumers subscribe
+ * with a callback and unsubscribe before they unload. */
+#define DL_CMX_EVENTFEED      "CMX::EventFeed"
+#define CMX_EVENTFEED_VERSION 2
+
+/* Records kept for consumers between ticks, older ones are dropped. */
+#define CMX_EVENTFEED_CAPACITY 8192
+
+#define EVENTRECORD_FLAG_CONDITION (1 << 0)
+#define EVENTRECORD_FLAG_CRITICAL  (1 << 1)
+#define EVENTRECORD_FLAG_FUMBLE    (1 << 2)
+#define EVENTRECORD_FLAG_OUTGOING  (1 << 3) // Source is self or owned by self.
+#define EVENTRECORD_FLAG_INCOMING  (1 << 4) // Destination is self.
+
+struct EventRecord_t
+{
+	uint64_t    Time;         // Unix time in ms.
+
+	/* Names point into the addon's agents and skills and are only valid during
+	 * the callback, copy them to keep them. Empty while the game has not
+	 * decoded them yet, nullptr if the agent or skill was freed before delivery. */
+	const char* SrcName;
+	const char* DstName;
+	const char* SkillName;
+
+	uint32_t    SrcID;
+	uint32_t    DstID;
+	uint32_t    SrcSpeciesID;
+	uint32_t    DstSpeciesID;
+	uint32_t    SkillID;
+
+	float       Value;        // Negative for damage, positive for healing.
+	float       ValueAlt;     // Barrier.
+
+	uint8_t     Type;         // 0 health, 1 down, 2 death.
+	uint8_t     Flags;        // EVENTRECORD_FLAG_*
+	uint16_t    Reserved;
+};
+
+/* Receives records in order. aDropped counts records lost since the last call
+ * because the consumer fell more than CMX_EVENTFEED_CAPACITY behind.
+ * Must not subscribe or unsubscribe from within the callback. */
+typedef void (*EVENTFEED_CALLBACK)(const EventRecord_t* aRecords, uint32_t aCount, uint32_t aDropped, void* aUserData);
+
+typedef uint32_t (*EVENTFEED_SUBSCRIBE)(EVENTFEED_CALLBACK aCallback, void* aUserData);
+typedef void     (*EVENTFEED_UNSUBSCRIBE)(uint32_t aHandle);
+
+struct EventFeedApi_t
+{
+	uint32_t              Version; // CMX_EVENTFEED_VERSION
+	uint32_t              Size;    // sizeof(EventFeedApi_t)
+	EVENTFEED_SUBSCRIBE   Subscribe;
+	EVENTFEED_UNSUBSCRIBE Unsubscribe;
+};
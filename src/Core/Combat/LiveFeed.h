@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+/* Live stats of the current encounter, shared with other addons through
+ * DataLink. The layout is fixed per version, consumers check Version and
+ * Size before reading and use LiveFeed_t::Read, which never blocks. */
+#define DL_CMX_LIVE      "CMX::LiveFeed"
+#define CMX_LIVE_VERSION 1
+
+/* Window in ms over which the rolling DPS is taken. */
+#define CMX_LIVE_ROLLING_WINDOW 5000
+
+struct LiveStats_t
+{
+	float Damage;  // Negative.
+	float Heal;
+	float Barrier;
+};
+
+struct LiveFeedData_t
+{
+	uint32_t    IsActive;   // Non-zero while in combat, the rest stays at the last encounter otherwise.
+	uint32_t    SpeciesID;  // Species of the trigger, 0 if none.
+	uint64_t    TimeStart;  // Unix time in ms.
+	uint32_t    Duration;   // ms
+	float       RollingDPS; // Target damage per second over the last CMX_LIVE_ROLLING_WINDOW, from a whole second.
+
+	LiveStats_t OutTarget;
+	LiveStats_t OutCleave;
+	LiveStats_t InTarget;
+	LiveStats_t InCleave;
+};
+
+struct LiveFeed_t
+{
+	uint32_t              Version;  // CMX_LIVE_VERSION, set once before the first publish.
+	uint32_t              Size;     // sizeof(LiveFeed_t)
+	std::atomic<uint32_t> Sequence; // Seqlock, odd while the data is being written.
+	uint32_t              Reserved;
+	LiveFeedData_t        Data;
+
+	/* Single writer. */
+	inline void Write(const LiveFeedData_t& aData)
+	{
+		uint32_t seq = this->Sequence.load(std::memory_order_relaxed);
+
+		this->Sequence.store(seq + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		std::memcpy(&this->Data, &aData, sizeof(LiveFeedData_t));
+
+		this->Sequence.store(seq + 2, std::memory_order_release);
+	}
+
+	/* Copies a consistent snapshot, returns false if the writer kept interfering. */
+	inline bool Read(LiveFeedData_t& aOut, uint32_t aAttempts = 16) const
+	{
+		for (uint32_t i = 0; i < aAttempts; i++)
+		{
+			uint32_t seq = this->Sequence.load(std::memory_order_acquire);
+
+			if (seq & 1) { continue; }
+
+			std::memcpy(&aOut, &this->Data, sizeof(LiveFeedData_t));
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			if (this->Sequence.load(std::memory_order_relaxed) == seq) { return true; }
+		}
+
+		return false;
+	}
+};
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "Sequence must be a plain 32-bit word.");
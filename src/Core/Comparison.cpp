@@ -0,0 +1,246 @@
+#include "Comparison.h"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "Core/Combat/CbtEncounter.h"
+
+#define COMPARISON_CACHE_SIZE 8
+
+namespace Comparison
+{
+	struct Job_t
+	{
+		Encounter_t* A;
+		Encounter_t* B;
+	};
+
+	struct Released_t
+	{
+		Encounter_t* Encounter;
+		void         (*Free)(Encounter_t*);
+	};
+
+	static std::thread                                            s_Thread;
+	static std::mutex                                             s_Mutex;
+	static std::condition_variable                                s_Signal;
+	static std::deque<Job_t>                                      s_Jobs;
+	static Job_t                                                  s_Current   = {}; // Pair the worker is reading.
+	static std::vector<Released_t>                                s_Released;       // Released while the worker reads them, freed by the worker.
+	static bool                                                   s_IsRunning = false;
+
+	static std::vector<std::shared_ptr<const ComparisonResult_t>> s_Results;          // Most recently used last.
+
+	std::shared_ptr<const ComparisonResult_t> Compute(const Encounter_t* aA, const Encounter_t* aB);
+	void ProcessJobs();
+}
+
+void Comparison::Create()
+{
+	const std::lock_guard<std::mutex> lock(s_Mutex);
+	if (s_IsRunning) { return; }
+
+	s_IsRunning = true;
+	s_Thread = std::thread(ProcessJobs);
+}
+
+void Comparison::Destroy()
+{
+	{
+		const std::lock_guard<std::mutex> lock(s_Mutex);
+		s_IsRunning = false;
+		s_Jobs.clear();
+	}
+	s_Signal.notify_all();
+
+	if (s_Thread.joinable())
+	{
+		s_Thread.join();
+	}
+
+	s_Results.clear();
+}
+
+std::shared_ptr<const ComparisonResult_t> Comparison::Get(Encounter_t* aA, Encounter_t* aB)
+{
+	if (!aA || !aB) { return nullptr; }
+
+	{
+		const std::lock_guard<std::mutex> lock(s_Mutex);
+
+		if (!s_IsRunning) { return nullptr; }
+
+		for (auto it = s_Results.begin(); it != s_Results.end(); it++)
+		{
+			if ((*it)->A != aA || (*it)->B != aB) { continue; }
+
+			std::shared_ptr<const ComparisonResult_t> result = *it;
+
+			/* Keep recently shown diffs in the cache. */
+			s_Results.erase(it);
+			s_Results.push_back(result);
+
+			return result;
+		}
+
+		bool isQueued = (s_Current.A == aA && s_Current.B == aB) || std::any_of(s_Jobs.begin(), s_Jobs.end(), [aA, aB](const Job_t& aJob) {
+			return aJob.A == aA && aJob.B == aB;
+		});
+
+		if (isQueued) { return nullptr; }
+
+		s_Jobs.push_back(Job_t{ aA, aB });
+	}
+	s_Signal.notify_one();
+
+	return nullptr;
+}
+
+void Comparison::Release(Encounter_t* aEncounter, void (*aFree)(Encounter_t*))
+{
+	{
+		const std::lock_guard<std::mutex> lock(s_Mutex);
+
+		auto uses = [aEncounter](const void* aA, const void* aB) { return aA == aEncounter || aB == aEncounter; };
+
+		s_Jobs.erase(std::remove_if(s_Jobs.begin(), s_Jobs.end(), [&uses](const Job_t& aJob) {
+			return uses(aJob.A, aJob.B);
+		}), s_Jobs.end());
+
+		s_Results.erase(std::remove_if(s_Results.begin(), s_Results.end(), [&uses](const std::shared_ptr<const ComparisonResult_t>& aResult) {
+			return uses(aResult->A, aResult->B);
+		}), s_Results.end());
+
+		if (uses(s_Current.A, s_Current.B))
+		{
+			s_Released.push_back(Released_t{ aEncounter, aFree });
+			return;
+		}
+	}
+
+	aFree(aEncounter);
+}
+
+std::shared_ptr<const ComparisonResult_t> Comparison::Compute(const Encounter_t* aA, const Encounter_t* aB)
+{
+	auto result = std::make_shared<ComparisonResult_t>();
+	result->A         = aA;
+	result->B         = aB;
+	result->DurationA = (uint32_t)(aA->TimeEnd - aA->TimeStart);
+	result->DurationB = (uint32_t)(aB->TimeEnd - aB->TimeStart);
+	result->DamageA   = abs(aA->OutTarget.Damage);
+	result->DamageB   = abs(aB->OutTarget.Damage);
+
+	/* Skills of both sides, matched by ID. */
+	float totalA = abs(aA->OutCleave.Damage);
+	float totalB = abs(aB->OutCleave.Damage);
+
+	aA->Skills.ForEach([&result, totalA](uint32_t aID, Skill_t* aSkill)
+	{
+		if (aSkill->Out.Hits == 0) { return; }
+
+		char  name[32];
+		float damage = abs(aSkill->Out.Damage);
+		result->Skills.push_back(SkillDelta_t{ aID, aSkill->GetName(name, sizeof(name)), damage, 0.f, totalA > 0.f ? damage / totalA : 0.f, 0.f });
+	});
+
+	std::sort(result->Skills.begin(), result->Skills.end(), [](const SkillDelta_t& aLeft, const SkillDelta_t& aRight) {
+		return aLeft.SkillID < aRight.SkillID;
+	});
+
+	size_t countA = result->Skills.size();
+
+	aB->Skills.ForEach([&result, totalB, countA](uint32_t aID, Skill_t* aSkill)
+	{
+		if (aSkill->Out.Hits == 0) { return; }
+
+		float damage = abs(aSkill->Out.Damage);
+		float share  = totalB > 0.f ? damage / totalB : 0.f;
+
+		auto end = result->Skills.begin() + countA;
+		auto it  = std::lower_bound(result->Skills.begin(), end, aID, [](const SkillDelta_t& aDelta, uint32_t aSkillID) {
+			return aDelta.SkillID < aSkillID;
+		});
+
+		if (it != end && it->SkillID == aID)
+		{
+			it->DamageB = damage;
+			it->ShareB  = share;
+		}
+		else
+		{
+			char name[32];
+			result->Skills.push_back(SkillDelta_t{ aID, aSkill->GetName(name, sizeof(name)), 0.f, damage, 0.f, share });
+		}
+	});
+
+	std::sort(result->Skills.begin(), result->Skills.end(), [](const SkillDelta_t& aLeft, const SkillDelta_t& aRight) {
+		return abs(aLeft.DamageB - aLeft.DamageA) > abs(aRight.DamageB - aRight.DamageA);
+	});
+
+	/* Cumulative DPS from the per-second samples, sample 0 is the start. */
+	auto buildCurve = [](const TimeIndex_t& aIndex, std::vector<float>& aCurve)
+	{
+		aCurve.reserve(aIndex.Samples.size());
+
+		for (size_t i = 1; i < aIndex.Samples.size(); i++)
+		{
+			aCurve.push_back((float)abs(aIndex.Samples[i].Damage) / (i * TIMEINDEX_SAMPLE_INTERVAL / 1000.f));
+		}
+	};
+
+	buildCurve(aA->OutTargetIndex, result->DpsA);
+	buildCurve(aB->OutTargetIndex, result->DpsB);
+
+	return result;
+}
+
+void Comparison::ProcessJobs()
+{
+	std::unique_lock<std::mutex> lock(s_Mutex);
+
+	while (s_IsRunning)
+	{
+		s_Signal.wait(lock, [] { return !s_IsRunning || !s_Jobs.empty(); });
+
+		if (!s_IsRunning) { break; }
+
+		Job_t job = s_Jobs.front();
+		s_Jobs.pop_front();
+		s_Current = job;
+
+		/* Encounters are sealed, Release() hands them to this thread instead of freeing them while they are read. */
+		lock.unlock();
+		std::shared_ptr<const ComparisonResult_t> result = Compute(job.A, job.B);
+		lock.lock();
+
+		s_Current = {};
+
+		if (!s_Released.empty())
+		{
+			/* Diff of a deleted encounter, nobody can ask for it anymore. */
+			std::vector<Released_t> released;
+			released.swap(s_Released);
+
+			lock.unlock();
+			for (const Released_t& entry : released)
+			{
+				entry.Free(entry.Encounter);
+			}
+			lock.lock();
+
+			continue;
+		}
+
+		s_Results.push_back(result);
+
+		if (s_Results.size() > COMPARISON_CACHE_SIZE)
+		{
+			s_Results.erase(s_Results.begin());
+		}
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct Encounter_t;
+
+/* Outgoing damage of one skill in both encounters, positive values. */
+struct SkillDelta_t
+{
+	uint32_t    SkillID;
+	std::string Name;
+	float       DamageA;
+	float       DamageB;
+	float       ShareA;  // Share of all outgoing damage, 0..1.
+	float       ShareB;
+};
+
+/* Immutable diff of two sealed encounters. */
+struct ComparisonResult_t
+{
+	const Encounter_t*        A         = nullptr; // Identity only, never dereferenced by the UI.
+	const Encounter_t*        B         = nullptr;
+
+	uint32_t                  DurationA = 0;       // ms
+	uint32_t                  DurationB = 0;
+	float                     DamageA   = 0.f;     // Outgoing target damage, positive.
+	float                     DamageB   = 0.f;
+
+	std::vector<SkillDelta_t> Skills;              // Sorted by the absolute damage delta, largest first.
+
+	/* Target DPS since start at every second, aligned by time since encounter start. */
+	std::vector<float>        DpsA;
+	std::vector<float>        DpsB;
+};
+
+/* Encounter diffs computed on a background worker, cached per encounter pair. */
+namespace Comparison
+{
+	void Create();
+
+	void Destroy();
+
+	/* Diff of two sealed encounters, nullptr while it is being computed. Never blocks on the computation. */
+	std::shared_ptr<const ComparisonResult_t> Get(Encounter_t* aA, Encounter_t* aB);
+
+	/* Drops cached and queued diffs of an encounter and frees it through aFree. Never waits,
+	 * an encounter the worker is reading right now is freed by the worker once it is done
+	 * and the diff it was computing is discarded. */
+	void Release(Encounter_t* aEncounter, void (*aFree)(Encounter_t*));
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* Open addressing hash map for non-zero uint32 keys with linear probing.
+ * Values are default constructed when absent, so pointers read as nullptr.
+ * Get() keeps the two most recently used entries in front of the table,
+ * consecutive combat events usually share their agents and skill.
+ * Set() may rehash and swap the slots, no lookup is safe against a concurrent
+ * writer. Other threads read under the writer's lock or once the map is sealed. */
+template<typename V>
+struct FlatMap_t
+{
+	struct Slot_t
+	{
+		uint32_t Key   = 0; // 0 marks an empty slot
+		V        Value = {};
+	};
+
+	std::vector<Slot_t> Slots;
+	size_t              Count          = 0;
+	uint32_t            Shift          = 32;
+
+	uint32_t            RecentKey[2]   = {};
+	V                   RecentValue[2] = {};
+	uint32_t            RecentNext     = 0;
+
+	/* Lookup through the recently used entries. Not safe for concurrent readers. */
+	inline V Get(uint32_t aKey)
+	{
+		if (aKey == 0)                   { return V{}; }
+		if (this->RecentKey[0] == aKey)  { return this->RecentValue[0]; }
+		if (this->RecentKey[1] == aKey)  { return this->RecentValue[1]; }
+
+		const Slot_t* slot = this->FindSlot(aKey);
+
+		if (!slot) { return V{}; }
+
+		this->RecentKey[this->RecentNext]   = aKey;
+		this->RecentValue[this->RecentNext] = slot->Value;
+		this->RecentNext ^= 1;
+
+		return slot->Value;
+	}
+
+	/* Lookup without touching the recently used entries, for const readers.
+	 * Requires the writer's lock unless the map is no longer written to. */
+	inline V Peek(uint32_t aKey) const
+	{
+		const Slot_t* slot = this->FindSlot(aKey);
+
+		return slot ? slot->Value : V{};
+	}
+
+	/* Inserts or replaces the value of the key. */
+	inline void Set(uint32_t aKey, V aValue)
+	{
+		if (aKey == 0) { return; }
+
+		if ((this->Count + 1) * 4 > this->Slots.size() * 3)
+		{
+			this->Rehash(this->Slots.empty() ? 16 : this->Slots.size() * 2);
+		}
+
+		if (this->Insert(aKey, aValue))
+		{
+			this->Count++;
+		}
+
+		for (uint32_t i = 0; i < 2; i++)
+		{
+			if (this->RecentKey[i] == aKey) { this->RecentValue[i] = aValue; }
+		}
+	}
+
+	template<typename F>
+	inline void ForEach(F aCallback) const
+	{
+		for (const Slot_t& slot : this->Slots)
+		{
+			if (slot.Key) { aCallback(slot.Key, slot.Value); }
+		}
+	}
+
+	inline size_t Size() const
+	{
+		return this->Count;
+	}
+
+	inline size_t Capacity() const
+	{
+		return this->Slots.size();
+	}
+
+	inline void Clear()
+	{
+		this->Slots.clear();
+		this->Count        = 0;
+		this->Shift        = 32;
+		this->RecentKey[0] = 0;
+		this->RecentKey[1] = 0;
+	}
+
+	/* Fibonacci hashing, sequential agent IDs spread across the table. */
+	inline size_t Hash(uint32_t aKey) const
+	{
+		return (size_t)((aKey * 2654435769u) >> this->Shift);
+	}
+
+	inline const Slot_t* FindSlot(uint32_t aKey) const
+	{
+		if (aKey == 0 || this->Slots.empty()) { return nullptr; }
+
+		size_t mask = this->Slots.size() - 1;
+
+		for (size_t i = this->Hash(aKey); ; i = (i + 1) & mask)
+		{
+			const Slot_t& slot = this->Slots[i];
+
+			if (slot.Key == aKey) { return &slot; }
+			if (slot.Key == 0)    { return nullptr; }
+		}
+	}
+
+	/* Returns true if the key was not present before. */
+	inline bool Insert(uint32_t aKey, V aValue)
+	{
+		size_t mask = this->Slots.size() - 1;
+
+		for (size_t i = this->Hash(aKey); ; i = (i + 1) & mask)
+		{
+			Slot_t& slot = this->Slots[i];
+
+			if (slot.Key == aKey)
+			{
+				slot.Value = aValue;
+				return false;
+			}
+
+			if (slot.Key == 0)
+			{
+				slot.Key   = aKey;
+				slot.Value = aValue;
+				return true;
+			}
+		}
+	}
+
+	inline void Rehash(size_t aCapacity)
+	{
+		std::vector<Slot_t> old;
+		old.swap(this->Slots);
+
+		this->Slots.resize(aCapacity);
+
+		/* Capacity is a power of two, the hash keeps the top log2(capacity) bits. */
+		this->Shift = 32;
+		for (size_t cap = aCapacity; cap > 1; cap >>= 1)
+		{
+			this->Shift--;
+		}
+
+		for (const Slot_t& slot : old)
+		{
+			if (slot.Key) { this->Insert(slot.Key, slot.Value); }
+		}
+	}
+};
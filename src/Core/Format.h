@@ -0,0 +1,165 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/* Formatting into caller provided buffers, nothing is allocated. Every
+ * function writes a null terminated string, truncated to the buffer, and
+ * returns the buffer so it can be passed on directly. */
+namespace Format
+{
+	struct Denomination_t
+	{
+		double      Value;
+		const char* Suffix;
+		int         Precision;
+	};
+
+	/* Largest first, values below the last entry are written without suffix. */
+	inline constexpr Denomination_t Denominations[] = {
+		{ 1e9, "B", 2 },
+		{ 1e6, "M", 2 },
+		{ 1e3, "k", 1 }
+	};
+
+	/* Appends text at aLength, which is advanced. A full buffer has aLength == aSize. Returns the buffer. */
+	inline char* Append(char* aBuffer, size_t aSize, size_t& aLength, const char* aText)
+	{
+		if (aLength >= aSize) { return aBuffer; }
+
+		size_t length = strlen(aText);
+
+		if (length > aSize - aLength - 1) { length = aSize - aLength - 1; }
+
+		memcpy(aBuffer + aLength, aText, length);
+		aLength += length;
+		aBuffer[aLength] = '\0';
+
+		return aBuffer;
+	}
+
+	/* Appends a fixed point number at aLength, which is advanced. Returns the buffer. */
+	inline char* AppendNumber(char* aBuffer, size_t aSize, size_t& aLength, double aValue, int aPrecision)
+	{
+		if (aLength + 1 >= aSize) { return aBuffer; }
+
+		std::to_chars_result result = std::to_chars(aBuffer + aLength, aBuffer + aSize - 1, aValue, std::chars_format::fixed, aPrecision);
+
+		if (result.ec != std::errc())
+		{
+			/* A number that does not fit ends the string, nothing is appended after it. */
+			aBuffer[aLength] = '\0';
+			aLength = aSize;
+			return aBuffer;
+		}
+
+		aLength = result.ptr - aBuffer;
+		aBuffer[aLength] = '\0';
+
+		return aBuffer;
+	}
+
+	/* Appends an integer at aLength, which is advanced. Returns the buffer. */
+	inline char* AppendInteger(char* aBuffer, size_t aSize, size_t& aLength, uint64_t aValue)
+	{
+		if (aLength + 1 >= aSize) { return aBuffer; }
+
+		std::to_chars_result result = std::to_chars(aBuffer + aLength, aBuffer + aSize - 1, aValue);
+
+		if (result.ec != std::errc())
+		{
+			aBuffer[aLength] = '\0';
+			aLength = aSize;
+			return aBuffer;
+		}
+
+		aLength = result.ptr - aBuffer;
+		aBuffer[aLength] = '\0';
+
+		return aBuffer;
+	}
+
+	inline char* Number(char* aBuffer, size_t aSize, double aValue, int aPrecision)
+	{
+		size_t length = 0;
+		aBuffer[0] = '\0';
+
+		return AppendNumber(aBuffer, aSize, length, aValue, aPrecision);
+	}
+
+	/* Two strings joined, e.g. a label and its ImGui ID. */
+	inline char* Join(char* aBuffer, size_t aSize, const char* aFirst, const char* aSecond)
+	{
+		size_t length = 0;
+		aBuffer[0] = '\0';
+
+		Append(aBuffer, aSize, length, aFirst);
+		return Append(aBuffer, aSize, length, aSecond);
+	}
+
+	/* Number shortened with k, M or B, followed by an optional suffix such as "/s".
+	 * The denomination is picked after rounding, 999960 is "1.00M" and not "1000.0k". */
+	inline char* Denominated(char* aBuffer, size_t aSize, double aValue, const char* aSuffix = "")
+	{
+		constexpr size_t count = sizeof(Denominations) / sizeof(Denominations[0]);
+
+		double magnitude = aValue < 0 ? -aValue : aValue;
+
+		/* First guess by magnitude, count stands for no denomination. */
+		size_t index = 0;
+		while (index < count && magnitude < Denominations[index].Value) { index++; }
+
+		for (;;)
+		{
+			size_t length = 0;
+			aBuffer[0] = '\0';
+
+			double scale     = index < count ? Denominations[index].Value : 1.;
+			int    precision = index < count ? Denominations[index].Precision : 0;
+
+			AppendNumber(aBuffer, aSize, length, aValue / scale, precision);
+
+			/* Rounded up to four integer digits, the next denomination takes over. */
+			const char* integer = aBuffer[0] == '-' ? aBuffer + 1 : aBuffer;
+			size_t      digits  = 0;
+			while (integer[digits] >= '0' && integer[digits] <= '9') { digits++; }
+
+			if (index > 0 && length < aSize && digits > 3)
+			{
+				index--;
+				continue;
+			}
+
+			if (index < count)
+			{
+				Append(aBuffer, aSize, length, Denominations[index].Suffix);
+			}
+
+			return Append(aBuffer, aSize, length, aSuffix);
+		}
+	}
+
+	/* Duration in ms as "1m5.25s" or "5.25s", rounded down to 10ms. */
+	inline char* Duration(char* aBuffer, size_t aSize, uint64_t aDurationMs)
+	{
+		size_t length = 0;
+		aBuffer[0] = '\0';
+
+		uint64_t seconds = aDurationMs / 1000;
+		uint64_t centis  = aDurationMs % 1000 / 10;
+
+		if (aDurationMs > 60000)
+		{
+			AppendInteger(aBuffer, aSize, length, seconds / 60);
+			Append(aBuffer, aSize, length, "m");
+			seconds %= 60;
+		}
+
+		AppendInteger(aBuffer, aSize, length, seconds);
+		Append(aBuffer, aSize, length, centis < 10 ? ".0" : ".");
+		AppendInteger(aBuffer, aSize, length, centis);
+		return Append(aBuffer, aSize, length, "s");
+	}
+}
@@ -0,0 +1,460 @@
+#include "HistoryIndex.h"
+
+#include <cctype>
+#include <condition_variable>
+#include <ctime>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include "Addon.h"
+#include "Core/Combat/CbtEncounter.h"
+#include "Util/src/Strings.h"
+
+#define HISTORYINDEX_FILE      "CombatMetrics/history.idx"
+#define HISTORYINDEX_MAGIC     0x58484D43 // "CMHX"
+#define HISTORYINDEX_VERSION   1
+#define HISTORYINDEX_MAX_BYTES (8 * 1024 * 1024)             // Summaries kept in memory and on disk.
+#define HISTORYINDEX_MAX_AGE   (90ull * 24 * 60 * 60 * 1000) // ms, older summaries are dropped.
+
+namespace HistoryIndex
+{
+	enum class EKeyDomain : uint8_t
+	{
+		Skill   = 'S',
+		Species = 'P',
+		Name    = 'N'
+	};
+
+	struct FileHeader_t
+	{
+		uint32_t Magic;
+		uint32_t Version;
+	};
+
+	using Summary_t = std::shared_ptr<const EncounterSummary_t>;
+
+	static AddonAPI_t*                    s_APIDefs      = nullptr;
+	static std::filesystem::path          s_Path;
+	static std::mutex                     s_Mutex;
+	static std::deque<Summary_t>          s_Summaries;             // Oldest first.
+	static size_t                         s_Bytes        = 0;      // Held by s_Summaries.
+
+	static std::thread                    s_Thread;
+	static std::condition_variable        s_Signal;
+	static std::vector<Summary_t>         s_Pending;               // Added but not yet appended to the file.
+	static bool                           s_IsCompacting = false;  // File holds dropped summaries or a torn tail, rewrite it.
+	static bool                           s_IsRunning    = false;
+
+	uint64_t Key(EKeyDomain aDomain, const void* aData, size_t aLength);
+	uint64_t KeyID(EKeyDomain aDomain, uint32_t aID);
+	uint64_t KeyName(const char* aName);
+	bool ParseID(const std::string& aQuery, uint32_t* aID);
+
+	size_t GetBytes(const EncounterSummary_t& aSummary);
+	void Evict(uint64_t aNow);
+	void WriteSummary(std::ofstream& aFile, const EncounterSummary_t& aSummary);
+	bool Append(const std::vector<Summary_t>& aSummaries);
+	bool Rewrite(const std::vector<Summary_t>& aSummaries);
+	void ProcessWrites();
+}
+
+uint64_t HistoryIndex::Key(EKeyDomain aDomain, const void* aData, size_t aLength)
+{
+	/* FNV-1a, finalized so low and high bits are both usable by the filter. */
+	uint64_t hash = 0xCBF29CE484222325ull;
+
+	hash = (hash ^ (uint8_t)aDomain) * 0x100000001B3ull;
+
+	for (size_t i = 0; i < aLength; i++)
+	{
+		hash = (hash ^ ((const uint8_t*)aData)[i]) * 0x100000001B3ull;
+	}
+
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDull;
+	hash ^= hash >> 33;
+
+	return hash;
+}
+
+uint64_t HistoryIndex::KeyID(EKeyDomain aDomain, uint32_t aID)
+{
+	return Key(aDomain, &aID, sizeof(aID));
+}
+
+uint64_t HistoryIndex::KeyName(const char* aName)
+{
+	char lower[128];
+	size_t length = 0;
+
+	for (; aName[length] && length < sizeof(lower); length++)
+	{
+		lower[length] = (char)std::tolower((unsigned char)aName[length]);
+	}
+
+	return Key(EKeyDomain::Name, lower, length);
+}
+
+bool HistoryIndex::ParseID(const std::string& aQuery, uint32_t* aID)
+{
+	if (aQuery.empty() || aQuery.size() > 10) { return false; }
+
+	uint64_t id = 0;
+
+	for (char c : aQuery)
+	{
+		if (c < '0' || c > '9') { return false; }
+
+		id = id * 10 + (c - '0');
+	}
+
+	if (id > UINT32_MAX) { return false; }
+
+	*aID = (uint32_t)id;
+	return true;
+}
+
+size_t HistoryIndex::GetBytes(const EncounterSummary_t& aSummary)
+{
+	return sizeof(EncounterSummary_t) + aSummary.Name.size() + aSummary.Filter.Words.size() * sizeof(uint64_t);
+}
+
+void HistoryIndex::Evict(uint64_t aNow)
+{
+	/* Dropped down to three quarters of the budget, the file is not rewritten for every new summary. */
+	bool isOverBudget = s_Bytes > HISTORYINDEX_MAX_BYTES;
+
+	while (!s_Summaries.empty())
+	{
+		const EncounterSummary_t& oldest = *s_Summaries.front();
+
+		bool isAged = oldest.TimeStart + HISTORYINDEX_MAX_AGE < aNow;
+
+		if (!isAged && !(isOverBudget && s_Bytes > HISTORYINDEX_MAX_BYTES / 4 * 3)) { break; }
+
+		s_Bytes -= GetBytes(oldest);
+		s_Summaries.pop_front();
+		s_IsCompacting = true;
+	}
+}
+
+void HistoryIndex::Create(AddonAPI_t* aApi)
+{
+	s_APIDefs = aApi;
+	s_Path = s_APIDefs->Paths_GetAddonDirectory(HISTORYINDEX_FILE);
+
+	const std::lock_guard<std::mutex> lock(s_Mutex);
+
+	if (s_IsRunning) { return; }
+
+	std::ifstream file(s_Path, std::ios::binary);
+
+	if (file.is_open())
+	{
+		FileHeader_t header{};
+		file.read((char*)&header, sizeof(header));
+
+		if (!file.good() || header.Magic != HISTORYINDEX_MAGIC || header.Version != HISTORYINDEX_VERSION)
+		{
+			s_APIDefs->Log(LOGL_WARNING, ADDON_NAME, "Ignoring invalid history index.");
+			s_IsCompacting = true;
+		}
+		else
+		{
+			for (;;)
+			{
+				auto summary = std::make_shared<EncounterSummary_t>();
+				uint16_t nameLength = 0;
+				uint32_t wordCount  = 0;
+
+				file.read((char*)&summary->TimeStart, sizeof(summary->TimeStart));
+
+				/* Clean end of the file. */
+				if (file.eof() && file.gcount() == 0) { break; }
+
+				file.read((char*)&summary->Duration, sizeof(summary->Duration));
+				file.read((char*)&summary->SpeciesID, sizeof(summary->SpeciesID));
+				file.read((char*)&nameLength, sizeof(nameLength));
+
+				if (file.good())
+				{
+					summary->Name.resize(nameLength);
+					file.read(summary->Name.data(), nameLength);
+					file.read((char*)&wordCount, sizeof(wordCount));
+				}
+
+				if (file.good() && wordCount <= BloomFilter_t::MaxBits / 64)
+				{
+					summary->Filter.Words.resize(wordCount);
+					file.read((char*)summary->Filter.Words.data(), wordCount * sizeof(uint64_t));
+				}
+
+				/* Torn by a crash while appending, later appends would follow the torn record. */
+				if (!file.good() || wordCount > BloomFilter_t::MaxBits / 64)
+				{
+					s_IsCompacting = true;
+					break;
+				}
+
+				s_Bytes += GetBytes(*summary);
+				s_Summaries.push_back(std::move(summary));
+			}
+		}
+	}
+
+	Evict((uint64_t)std::time(nullptr) * 1000);
+
+	s_IsRunning = true;
+	s_Thread = std::thread(ProcessWrites);
+}
+
+void HistoryIndex::Destroy()
+{
+	if (!s_APIDefs) { return; }
+
+	{
+		const std::lock_guard<std::mutex> lock(s_Mutex);
+		s_IsRunning = false;
+	}
+	s_Signal.notify_all();
+
+	/* Flushes what is pending before it exits. */
+	if (s_Thread.joinable())
+	{
+		s_Thread.join();
+	}
+
+	const std::lock_guard<std::mutex> lock(s_Mutex);
+	s_Summaries.clear();
+	s_Bytes = 0;
+}
+
+void HistoryIndex::WriteSummary(std::ofstream& aFile, const EncounterSummary_t& aSummary)
+{
+	uint16_t nameLength = (uint16_t)(aSummary.Name.size() < UINT16_MAX ? aSummary.Name.size() : UINT16_MAX);
+	uint32_t wordCount  = (uint32_t)aSummary.Filter.Words.size();
+
+	aFile.write((const char*)&aSummary.TimeStart, sizeof(aSummary.TimeStart));
+	aFile.write((const char*)&aSummary.Duration, sizeof(aSummary.Duration));
+	aFile.write((const char*)&aSummary.SpeciesID, sizeof(aSummary.SpeciesID));
+	aFile.write((const char*)&nameLength, sizeof(nameLength));
+	aFile.write(aSummary.Name.data(), nameLength);
+	aFile.write((const char*)&wordCount, sizeof(wordCount));
+	aFile.write((const char*)aSummary.Filter.Words.data(), wordCount * sizeof(uint64_t));
+}
+
+bool HistoryIndex::Append(const std::vector<Summary_t>& aSummaries)
+{
+	std::error_code ec;
+	std::filesystem::create_directories(s_Path.parent_path(), ec);
+
+	uintmax_t size = std::filesystem::file_size(s_Path, ec);
+
+	std::ofstream file(s_Path, std::ios::binary | std::ios::app);
+
+	if (!file.is_open()) { return false; }
+
+	if (ec || size == 0)
+	{
+		FileHeader_t header{ HISTORYINDEX_MAGIC, HISTORYINDEX_VERSION };
+		file.write((const char*)&header, sizeof(header));
+	}
+
+	for (const Summary_t& summary : aSummaries)
+	{
+		WriteSummary(file, *summary);
+	}
+
+	file.flush();
+
+	return file.good();
+}
+
+bool HistoryIndex::Rewrite(const std::vector<Summary_t>& aSummaries)
+{
+	/* Written aside and renamed, a crash never leaves a torn index. */
+	std::filesystem::path tmpPath = s_Path;
+	tmpPath += ".tmp";
+
+	std::error_code ec;
+	std::filesystem::create_directories(s_Path.parent_path(), ec);
+
+	{
+		std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+
+		if (!file.is_open()) { return false; }
+
+		FileHeader_t header{ HISTORYINDEX_MAGIC, HISTORYINDEX_VERSION };
+		file.write((const char*)&header, sizeof(header));
+
+		for (const Summary_t& summary : aSummaries)
+		{
+			WriteSummary(file, *summary);
+		}
+
+		if (!file.good()) { return false; }
+	}
+
+	std::filesystem::rename(tmpPath, s_Path, ec);
+
+	return !ec;
+}
+
+void HistoryIndex::ProcessWrites()
+{
+	std::unique_lock<std::mutex> lock(s_Mutex);
+
+	for (;;)
+	{
+		s_Signal.wait(lock, [] { return !s_IsRunning || !s_Pending.empty() || s_IsCompacting; });
+
+		bool isWritten = true;
+
+		if (s_IsCompacting)
+		{
+			/* The rewrite covers the pending summaries as well. */
+			std::vector<Summary_t> summaries(s_Summaries.begin(), s_Summaries.end());
+			s_Pending.clear();
+			s_IsCompacting = false;
+
+			lock.unlock();
+			isWritten = Rewrite(summaries);
+			lock.lock();
+		}
+		else if (!s_Pending.empty())
+		{
+			std::vector<Summary_t> pending;
+			pending.swap(s_Pending);
+
+			lock.unlock();
+			isWritten = Append(pending);
+			lock.lock();
+		}
+
+		if (!isWritten)
+		{
+			s_APIDefs->Log(LOGL_WARNING, ADDON_NAME, "Could not write history index.");
+		}
+
+		if (!s_IsRunning && s_Pending.empty() && !s_IsCompacting) { break; }
+	}
+}
+
+void HistoryIndex::Add(Encounter_t* aEncounter)
+{
+	char name[192];
+
+	auto summary = std::make_shared<EncounterSummary_t>();
+	summary->TimeStart = aEncounter->TimeStart;
+	summary->Duration  = (uint32_t)(aEncounter->TimeEnd - aEncounter->TimeStart);
+	summary->SpeciesID = aEncounter->SpeciesID;
+	summary->Name      = aEncounter->GetName(name, sizeof(name));
+
+	/* Skills add their ID and name, agents their name and non-players their species. */
+	summary->Filter.Reset(aEncounter->Skills.Size() * 2 + aEncounter->AgentList.size() * 2);
+
+	aEncounter->Skills.ForEach([&summary](uint32_t aID, Skill_t* aSkill)
+	{
+		summary->Filter.Add(KeyID(EKeyDomain::Skill, aID));
+
+		if (aSkill->Name[0])
+		{
+			summary->Filter.Add(KeyName(aSkill->Name));
+		}
+	});
+
+	for (const Agent_t* agent : aEncounter->AgentList)
+	{
+		if (agent->Name[0])
+		{
+			summary->Filter.Add(KeyName(agent->Name));
+		}
+
+		if (!agent->IsPlayer && agent->SpeciesID)
+		{
+			summary->Filter.Add(KeyID(EKeyDomain::Species, agent->SpeciesID));
+		}
+	}
+
+	{
+		const std::lock_guard<std::mutex> lock(s_Mutex);
+
+		if (!s_IsRunning) { return; }
+
+		s_Bytes += GetBytes(*summary);
+		s_Summaries.push_back(summary);
+		s_Pending.push_back(summary);
+
+		Evict(aEncounter->TimeEnd);
+	}
+	s_Signal.notify_one();
+}
+
+std::vector<std::shared_ptr<const EncounterSummary_t>> HistoryIndex::Search(const std::string& aQuery)
+{
+	std::vector<Summary_t> results;
+
+	if (aQuery.empty()) { return results; }
+
+	uint32_t id = 0;
+	bool isID = ParseID(aQuery, &id);
+
+	uint64_t keyName    = KeyName(aQuery.c_str());
+	uint64_t keySkill   = isID ? KeyID(EKeyDomain::Skill, id) : 0;
+	uint64_t keySpecies = isID ? KeyID(EKeyDomain::Species, id) : 0;
+
+	const std::lock_guard<std::mutex> lock(s_Mutex);
+
+	for (auto it = s_Summaries.rbegin(); it != s_Summaries.rend(); it++)
+	{
+		const BloomFilter_t& filter = (*it)->Filter;
+
+		bool isCandidate = isID
+			? filter.MayContain(keySkill) || filter.MayContain(keySpecies)
+			: filter.MayContain(keyName);
+
+		if (isCandidate)
+		{
+			results.push_back(*it);
+		}
+	}
+
+	return results;
+}
+
+bool HistoryIndex::Matches(Encounter_t* aEncounter, const std::string& aQuery)
+{
+	uint32_t id = 0;
+	bool isID = ParseID(aQuery, &id);
+
+	auto equalsQuery = [&aQuery](const char* aName)
+	{
+		size_t i = 0;
+
+		for (; aName[i] && i < aQuery.size(); i++)
+		{
+			if (std::tolower((unsigned char)aName[i]) != std::tolower((unsigned char)aQuery[i])) { return false; }
+		}
+
+		return !aName[i] && i == aQuery.size();
+	};
+
+	bool isMatch = false;
+
+	aEncounter->Skills.ForEach([&](uint32_t aID, Skill_t* aSkill)
+	{
+		isMatch = isMatch || (isID ? aID == id : equalsQuery(aSkill->Name));
+	});
+
+	for (const Agent_t* agent : aEncounter->AgentList)
+	{
+		if (isMatch) { break; }
+
+		isMatch = isID ? !agent->IsPlayer && agent->SpeciesID == id : equalsQuery(agent->Name);
+	}
+
+	return isMatch;
+}
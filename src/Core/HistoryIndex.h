@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Nexus/Nexus.h"
+
+struct Encounter_t;
+
+/* Bloom filter over 64-bit keys, sized per encounter for ~1% false positives. */
+struct BloomFilter_t
+{
+	static constexpr uint32_t Hashes  = 7;
+	static constexpr uint32_t MinBits = 512;
+	static constexpr uint32_t MaxBits = 1 << 17;
+
+	std::vector<uint64_t> Words;
+
+	inline void Reset(size_t aItems)
+	{
+		uint32_t bits = MinBits;
+
+		while (bits < aItems * 10 && bits < MaxBits) { bits <<= 1; }
+
+		this->Words.assign(bits / 64, 0);
+	}
+
+	inline void Add(uint64_t aKey)
+	{
+		uint64_t bits = this->Words.size() * 64;
+		uint64_t h2   = (aKey >> 32) | 1;
+
+		for (uint32_t i = 0; i < Hashes; i++)
+		{
+			uint64_t bit = (aKey + i * h2) & (bits - 1);
+			this->Words[bit / 64] |= 1ull << (bit % 64);
+		}
+	}
+
+	/* False if the key was never added, true if it probably was. */
+	inline bool MayContain(uint64_t aKey) const
+	{
+		if (this->Words.empty()) { return false; }
+
+		uint64_t bits = this->Words.size() * 64;
+		uint64_t h2   = (aKey >> 32) | 1;
+
+		for (uint32_t i = 0; i < Hashes; i++)
+		{
+			uint64_t bit = (aKey + i * h2) & (bits - 1);
+
+			if (!(this->Words[bit / 64] & (1ull << (bit % 64)))) { return false; }
+		}
+
+		return true;
+	}
+};
+
+/* What an encounter involved, kept after the encounter itself is gone. */
+struct EncounterSummary_t
+{
+	uint64_t      TimeStart = 0; // Unix time in ms, identifies the encounter.
+	uint32_t      Duration  = 0; // ms
+	uint32_t      SpeciesID = 0; // Species of the trigger.
+	std::string   Name;
+	BloomFilter_t Filter;        // Skill IDs, species IDs and names of skills, agents and players.
+};
+
+/* Summaries of recent encounters, persisted in CombatMetrics/history.idx.
+ * Old summaries age out and the total size is capped, see HistoryIndex.cpp.
+ * Every summary is appended to the file on a background thread as soon as it
+ * is added. Searches only test the filters, encounters are opened by the
+ * caller for the candidates. */
+namespace HistoryIndex
+{
+	/* Reads the persisted summaries and starts the writer. */
+	void Create(AddonAPI_t* aApi);
+
+	/* Writes what is still pending and stops the writer. */
+	void Destroy();
+
+	/* Summarizes a sealed encounter, the file write happens in the background. */
+	void Add(Encounter_t* aEncounter);
+
+	/* Encounters that may match the query, newest first. A numeric query
+	 * matches skill and species IDs, any other query a full name, ignoring
+	 * case. Summaries are immutable, results stay valid after they age out. */
+	std::vector<std::shared_ptr<const EncounterSummary_t>> Search(const std::string& aQuery);
+
+	/* Exact test of a loaded encounter, rules out the false positives of the filter. */
+	bool Matches(Encounter_t* aEncounter, const std::string& aQuery);
+}
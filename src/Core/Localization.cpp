@@ -13,44 +13,164 @@ void Localization::Init(AddonAPI_t* aApi)
 {
 	s_APIDefs = aApi;
 
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::ActiveTime), "en", "Active");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::ActiveTime), "de", "Aktiv");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::ActiveTimeGap), "en", "Pause excluded from active time");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::ActiveTimeGap), "de", "Pause ohne aktive Zeit");
+
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::Barrier), "en", "Barrier");
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::Barrier), "de", "Schild");
 
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Buffs), "en", "Buffs");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Buffs), "de", "Effekte");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::CaptureFull), "en", "Full");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::CaptureFull), "de", "Alles");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::CaptureMode), "en", "Capture mode");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::CaptureMode), "de", "Erfassungsmodus");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::CaptureSelfOnly), "en", "Self only");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::CaptureSelfOnly), "de", "Nur eigene");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::CaptureSquad), "en", "Squad");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::CaptureSquad), "de", "Trupp");
+
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::Cleave), "en", "Cleave");
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::Cleave), "de", "Spalten");
 
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Condition), "en", "Condition");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Condition), "de", "Zustand");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::CritRate), "en", "Critical");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::CritRate), "de", "Kritisch");
+
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::CombatMetrics), "en", "Combat Metrics");
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::CombatMetrics), "de", "Kampfstatistiken");
 
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Compare), "en", "Compare");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Compare), "de", "Vergleichen");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Computing), "en", "Computing...");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Computing), "de", "Wird berechnet...");
+
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::Damage), "en", "Damage");
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::Damage), "de", "Schaden");
 
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Dead), "en", "Dead");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Dead), "de", "Tot");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::DeathRecap), "en", "Death Recap");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::DeathRecap), "de", "Todesursache");
+
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::DisabledCombatTracker), "en", "Combat Tracker not registered.");
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::DisabledCombatTracker), "de", "Kampfprotokoll nicht registriert.");
 
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::DisabledInPvP), "en", "Disabled in PvP.");
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::DisabledInPvP), "de", "Im PvP deaktiviert.");
 
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Downed), "en", "Downed");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Downed), "de", "Angeschlagen");
+
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::Duration), "en", "Duration");
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::Duration), "de", "Dauer");
 
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::ExportCSV), "en", "Export CSV");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::ExportCSV), "de", "CSV exportieren");
+
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::Heal), "en", "Healing");
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::Heal), "de", "Heilung");
 
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::HistoryMemoryBudget), "en", "History memory budget");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::HistoryMemoryBudget), "de", "Speicherbudget des Verlaufs");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::HitRange), "en", "Min/Max hit");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::HitRange), "de", "Min./Max. Treffer");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Hits), "en", "Hits");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Hits), "de", "Treffer");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::InstanceGracePeriod), "en", "Out of combat grace period in instances");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::InstanceGracePeriod), "de", "Nachlaufzeit ohne Kampf in Instanzen");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::NoBuffs), "en", "No buffs.");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::NoBuffs), "de", "Keine Effekte.");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::NoResults), "en", "No matches.");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::NoResults), "de", "Keine Treffer.");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::NoSkills), "en", "No skill hits.");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::NoSkills), "de", "Keine Fertigkeitstreffer.");
+
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::NoTargets), "en", "No targets.");
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::NoTargets), "de", "Keine Gegner.");
 
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::Incoming), "en", "Incoming");
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::Incoming), "de", "Erhalten");
 
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Latency), "en", "Latency");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Latency), "de", "Latenz");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::MaxStacks), "en", "Max stacks");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::MaxStacks), "de", "Max. Stapel");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Median), "en", "Median");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Median), "de", "Median");
+
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::Outgoing), "en", "Outgoing");
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::Outgoing), "de", "Verteilt");
 
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::PersonalBest), "en", "Personal best");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::PersonalBest), "de", "Bestzeit");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Phases), "en", "Phases");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Phases), "de", "Phasen");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Power), "en", "Power");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Power), "de", "Kraft");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::RecapTruncated), "en", "Earlier hits of the last 10s not shown.");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::RecapTruncated), "de", "Vorherige Treffer der letzten 10s nicht angezeigt.");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Reset), "en", "Reset");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Reset), "de", "Leeren");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Search), "en", "Search");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Search), "de", "Suchen");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Self), "en", "Self");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Self), "de", "Selbst");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Share), "en", "Share");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Share), "de", "Anteil");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Skills), "en", "Skills");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Skills), "de", "Fertigkeiten");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::SpillToDisk), "en", "Write event logs to disk");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::SpillToDisk), "de", "Ereignisprotokolle auf Festplatte schreiben");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Squad), "en", "Squad");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Squad), "de", "Trupp");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Stacks), "en", "Stacks");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Stacks), "de", "Stapel");
+
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::Target), "en", "Target");
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::Target), "de", "Ziel");
 
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::TimeWindow), "en", "Time Window");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::TimeWindow), "de", "Zeitfenster");
+
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::Total), "en", "Total");
 	s_APIDefs->Localization_Set(LANG_ID(ETexts::Total), "de", "Gesamt");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Uptime), "en", "Uptime");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::Uptime), "de", "Laufzeit");
+
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::WholeHistory), "en", "Whole history");
+	s_APIDefs->Localization_Set(LANG_ID(ETexts::WholeHistory), "de", "Gesamter Verlauf");
 }
 
 const char* Translate(ETexts aID)
@@ -4,19 +4,59 @@
 
 enum class ETexts
 {
+	ActiveTime,
+	ActiveTimeGap,
 	Barrier,
+	Buffs,
+	CaptureFull,
+	CaptureMode,
+	CaptureSelfOnly,
+	CaptureSquad,
 	Cleave,
+	Condition,
+	CritRate,
 	CombatMetrics,
+	Compare,
+	Computing,
 	Damage,
+	Dead,
+	DeathRecap,
 	DisabledCombatTracker,
 	DisabledInPvP,
+	Downed,
 	Duration,
+	ExportCSV,
 	Heal,
+	HistoryMemoryBudget,
+	HitRange,
+	Hits,
+	InstanceGracePeriod,
+	NoBuffs,
+	NoResults,
+	NoSkills,
 	NoTargets,
 	Incoming,
+	Latency,
+	MaxStacks,
+	Median,
 	Outgoing,
+	PersonalBest,
+	Phases,
+	Power,
+	RecapTruncated,
+	Reset,
+	Search,
+	Self,
+	Share,
+	Skills,
+	SpillToDisk,
+	Squad,
+	Stacks,
 	Target,
-	Total
+	TimeWindow,
+	Total,
+	Uptime,
+	WholeHistory
 };
 
 namespace Localization
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/* Log-linear bucketing of unsigned values: values below 16 get a bucket each,
+ * every power of two above is split into 16 linear buckets (~6% precision). */
+namespace LogBuckets
+{
+	inline constexpr uint32_t SubBucketBits = 4;
+	inline constexpr uint32_t SubBuckets    = 1 << SubBucketBits;
+	inline constexpr uint32_t Magnitudes    = 36; // Up to ~1.1e12, larger values share the last bucket.
+	inline constexpr uint32_t Count         = SubBuckets + Magnitudes * SubBuckets;
+
+	inline uint32_t Index(uint64_t aValue)
+	{
+		if (aValue < SubBuckets) { return (uint32_t)aValue; }
+
+#if defined(_MSC_VER)
+		unsigned long msb;
+		_BitScanReverse64(&msb, aValue);
+#else
+		uint32_t msb = 63 - __builtin_clzll(aValue);
+#endif
+
+		uint32_t shift = msb - SubBucketBits;
+
+		if (shift >= Magnitudes) { return Count - 1; }
+
+		return SubBuckets + shift * SubBuckets + (uint32_t)((aValue >> shift) - SubBuckets);
+	}
+
+	/* Lowest value that falls into the given bucket. */
+	inline uint64_t Value(uint32_t aIndex)
+	{
+		if (aIndex < SubBuckets) { return aIndex; }
+
+		uint32_t shift = (aIndex - SubBuckets) / SubBuckets;
+		uint32_t sub   = (aIndex - SubBuckets) % SubBuckets;
+
+		return (uint64_t)(SubBuckets + sub) << shift;
+	}
+}
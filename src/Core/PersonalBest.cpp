@@ -0,0 +1,281 @@
+#include "PersonalBest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "Addon.h"
+#include "Util/src/Strings.h"
+
+#define PERSONALBEST_DIRECTORY "CombatMetrics/pb"
+#define PERSONALBEST_MAGIC     0x42504D43 // "CMPB"
+#define PERSONALBEST_VERSION   1
+
+namespace PersonalBest
+{
+	struct Job_t
+	{
+		uint32_t           SpeciesID;
+		bool               IsStore;
+		uint32_t           Duration;
+		std::vector<float> Damage;
+	};
+
+	struct FileHeader_t
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t SpeciesID;
+		uint32_t Duration;
+		uint32_t Count;
+	};
+
+	static AddonAPI_t*                                       s_APIDefs    = nullptr;
+	static std::string                                       s_Directory;
+
+	static std::thread                                       s_Thread;
+	static std::mutex                                        s_Mutex;
+	static std::condition_variable                           s_Signal;
+	static std::deque<Job_t>                                 s_Jobs;
+	static bool                                              s_IsRunning  = false;
+
+	static std::vector<uint32_t>                             s_Requested;  // Species already looked up on disk.
+	static std::vector<std::shared_ptr<const PacingCurve_t>> s_Curves;     // Guarded by s_Mutex.
+	static std::atomic<uint32_t>                             s_Generation = 0;
+
+	std::string GetPath(uint32_t aSpeciesID);
+	std::shared_ptr<const PacingCurve_t> Read(uint32_t aSpeciesID);
+	bool Write(const PacingCurve_t& aCurve);
+	void Publish(std::shared_ptr<const PacingCurve_t> aCurve);
+	void ProcessJobs();
+}
+
+void PersonalBest::Create(AddonAPI_t* aApi)
+{
+	s_APIDefs = aApi;
+	s_Directory = s_APIDefs->Paths_GetAddonDirectory(PERSONALBEST_DIRECTORY);
+
+	std::error_code ec;
+	std::filesystem::create_directories(s_Directory, ec);
+
+	const std::lock_guard<std::mutex> lock(s_Mutex);
+	if (s_IsRunning) { return; }
+
+	s_IsRunning = true;
+	s_Thread = std::thread(ProcessJobs);
+}
+
+void PersonalBest::Destroy()
+{
+	{
+		const std::lock_guard<std::mutex> lock(s_Mutex);
+		s_IsRunning = false;
+	}
+	s_Signal.notify_all();
+
+	if (s_Thread.joinable())
+	{
+		s_Thread.join();
+	}
+}
+
+void PersonalBest::Request(uint32_t aSpeciesID)
+{
+	{
+		const std::lock_guard<std::mutex> lock(s_Mutex);
+
+		if (!s_IsRunning) { return; }
+
+		if (std::find(s_Requested.begin(), s_Requested.end(), aSpeciesID) != s_Requested.end()) { return; }
+
+		s_Requested.push_back(aSpeciesID);
+		s_Jobs.push_back(Job_t{ aSpeciesID, false, 0, {} });
+	}
+	s_Signal.notify_one();
+}
+
+void PersonalBest::Submit(uint32_t aSpeciesID, uint32_t aDuration, std::vector<float>&& aDamage)
+{
+	{
+		const std::lock_guard<std::mutex> lock(s_Mutex);
+
+		if (!s_IsRunning) { return; }
+
+		/* One sample per second up to the kill, Read() rejects anything longer. */
+		if (aDamage.size() > aDuration / 1000 + 1) { aDamage.resize(aDuration / 1000 + 1); }
+
+		s_Jobs.push_back(Job_t{ aSpeciesID, true, aDuration, std::move(aDamage) });
+	}
+	s_Signal.notify_one();
+}
+
+std::shared_ptr<const PacingCurve_t> PersonalBest::Get(uint32_t aSpeciesID)
+{
+	const std::lock_guard<std::mutex> lock(s_Mutex);
+
+	for (const std::shared_ptr<const PacingCurve_t>& curve : s_Curves)
+	{
+		if (curve->SpeciesID == aSpeciesID) { return curve; }
+	}
+
+	return nullptr;
+}
+
+uint32_t PersonalBest::GetGeneration()
+{
+	return s_Generation.load(std::memory_order_acquire);
+}
+
+std::string PersonalBest::GetPath(uint32_t aSpeciesID)
+{
+	return (std::filesystem::path(s_Directory) / (std::to_string(aSpeciesID) + ".bin")).string();
+}
+
+std::shared_ptr<const PacingCurve_t> PersonalBest::Read(uint32_t aSpeciesID)
+{
+	std::ifstream file(GetPath(aSpeciesID), std::ios::binary);
+
+	if (!file.is_open()) { return nullptr; }
+
+	FileHeader_t header{};
+	file.read((char*)&header, sizeof(header));
+
+	if (!file.good() || header.Magic != PERSONALBEST_MAGIC || header.Version != PERSONALBEST_VERSION || header.SpeciesID != aSpeciesID)
+	{
+		s_APIDefs->Log(LOGL_WARNING, ADDON_NAME, String::Format("Ignoring invalid personal best for species %u.", aSpeciesID).c_str());
+		return nullptr;
+	}
+
+	/* Count comes from disk, bound it by what the file holds and by the kill time before allocating. */
+	std::streamoff offset = file.tellg();
+	file.seekg(0, std::ios::end);
+	std::streamoff remaining = file.tellg() - offset;
+	file.seekg(offset);
+
+	if (!file.good() || header.Count > header.Duration / 1000 + 1 || (uint64_t)header.Count * sizeof(float) > (uint64_t)remaining)
+	{
+		s_APIDefs->Log(LOGL_WARNING, ADDON_NAME, String::Format("Ignoring truncated personal best for species %u.", aSpeciesID).c_str());
+		return nullptr;
+	}
+
+	auto curve = std::make_shared<PacingCurve_t>();
+	curve->SpeciesID = header.SpeciesID;
+	curve->Duration  = header.Duration;
+	curve->Damage.resize(header.Count);
+
+	file.read((char*)curve->Damage.data(), header.Count * sizeof(float));
+
+	if (!file.good()) { return nullptr; }
+
+	return curve;
+}
+
+bool PersonalBest::Write(const PacingCurve_t& aCurve)
+{
+	/* Written aside and renamed, a crash never leaves a torn best. */
+	std::string path = GetPath(aCurve.SpeciesID);
+	std::string tmpPath = path + ".tmp";
+
+	{
+		std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+
+		if (!file.is_open()) { return false; }
+
+		FileHeader_t header{ PERSONALBEST_MAGIC, PERSONALBEST_VERSION, aCurve.SpeciesID, aCurve.Duration, (uint32_t)aCurve.Damage.size() };
+		file.write((const char*)&header, sizeof(header));
+		file.write((const char*)aCurve.Damage.data(), aCurve.Damage.size() * sizeof(float));
+
+		if (!file.good()) { return false; }
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(tmpPath, path, ec);
+
+	return !ec;
+}
+
+void PersonalBest::Publish(std::shared_ptr<const PacingCurve_t> aCurve)
+{
+	{
+		const std::lock_guard<std::mutex> lock(s_Mutex);
+
+		auto it = std::find_if(s_Curves.begin(), s_Curves.end(), [&aCurve](const std::shared_ptr<const PacingCurve_t>& aEntry) {
+			return aEntry->SpeciesID == aCurve->SpeciesID;
+		});
+
+		if (it != s_Curves.end())
+		{
+			*it = aCurve;
+		}
+		else
+		{
+			s_Curves.push_back(aCurve);
+		}
+	}
+
+	s_Generation.fetch_add(1, std::memory_order_release);
+}
+
+void PersonalBest::ProcessJobs()
+{
+	for (;;)
+	{
+		Job_t job;
+
+		{
+			std::unique_lock<std::mutex> lock(s_Mutex);
+			s_Signal.wait(lock, [] { return !s_Jobs.empty() || !s_IsRunning; });
+
+			/* Pending kills are still stored on shutdown, pending loads are not needed anymore. */
+			if (s_Jobs.empty()) { return; }
+
+			job = std::move(s_Jobs.front());
+			s_Jobs.pop_front();
+
+			if (!s_IsRunning && !job.IsStore) { continue; }
+		}
+
+		if (!job.IsStore)
+		{
+			if (std::shared_ptr<const PacingCurve_t> curve = Read(job.SpeciesID))
+			{
+				Publish(curve);
+			}
+
+			continue;
+		}
+
+		std::shared_ptr<const PacingCurve_t> best = Get(job.SpeciesID);
+		bool isKnown = best != nullptr;
+
+		if (!isKnown)
+		{
+			best = Read(job.SpeciesID);
+		}
+
+		if (best && best->Duration <= job.Duration)
+		{
+			/* Make sure the stored best is known even if it was never requested. */
+			if (!isKnown) { Publish(best); }
+			continue;
+		}
+
+		auto curve = std::make_shared<PacingCurve_t>();
+		curve->SpeciesID = job.SpeciesID;
+		curve->Duration  = job.Duration;
+		curve->Damage    = std::move(job.Damage);
+
+		if (!Write(*curve))
+		{
+			s_APIDefs->Log(LOGL_WARNING, ADDON_NAME, String::Format("Could not store personal best for species %u.", job.SpeciesID).c_str());
+		}
+
+		Publish(curve);
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Nexus/Nexus.h"
+
+/* Cumulative target damage of a kill, one sample per second. */
+struct PacingCurve_t
+{
+	uint32_t           SpeciesID = 0;
+	uint32_t           Duration  = 0;  // Kill time in ms.
+	std::vector<float> Damage;         // Positive, Damage[i] is the total after i seconds.
+
+	/* Damage dealt by the curve at the given ms since encounter start. O(1). */
+	inline float At(uint32_t aTime) const
+	{
+		if (this->Damage.empty()) { return 0.f; }
+
+		size_t idx = aTime / 1000;
+
+		if (idx + 1 >= this->Damage.size()) { return this->Damage.back(); }
+
+		float frac = (aTime % 1000) / 1000.f;
+
+		return this->Damage[idx] + (this->Damage[idx + 1] - this->Damage[idx]) * frac;
+	}
+};
+
+namespace PersonalBest
+{
+	/* Starts the loader thread, curves are kept in CombatMetrics/pb. */
+	void Create(AddonAPI_t* aApi);
+
+	void Destroy();
+
+	/* Loads the best curve of the species in the background, if not already known. */
+	void Request(uint32_t aSpeciesID);
+
+	/* Offers a kill in the background, it replaces the stored curve if it is faster. */
+	void Submit(uint32_t aSpeciesID, uint32_t aDuration, std::vector<float>&& aDamage);
+
+	/* Best known curve of the species or nullptr. */
+	std::shared_ptr<const PacingCurve_t> Get(uint32_t aSpeciesID);
+
+	/* Incremented whenever a curve is published, to refresh cached lookups. */
+	uint32_t GetGeneration();
+}
@@ -0,0 +1,64 @@
+#include "Profiler.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include "Format.h"
+
+namespace Profiler
+{
+	Histogram_t  CombatEvent("OnCombatEvent");
+	Histogram_t  Advance("Combat::Advance");
+	Histogram_t  Render("UiRoot::Render");
+
+	Histogram_t* All[] = { &CombatEvent, &Advance, &Render, nullptr };
+}
+
+bool Profiler::DumpCSV(const char* aPath)
+{
+	std::filesystem::path path = aPath;
+
+	std::error_code ec;
+	std::filesystem::create_directories(path.parent_path(), ec);
+
+	std::ofstream file(path, std::ios::trunc);
+
+	if (!file.is_open()) { return false; }
+
+	file << "name,count,mean_ns,p50_ns,p90_ns,p99_ns,p999_ns,max_ns\n";
+
+	for (Histogram_t** it = All; *it; it++)
+	{
+		Histogram_t* hist = *it;
+
+		uint64_t count = hist->Count.load(std::memory_order_relaxed);
+		uint64_t total = hist->Total.load(std::memory_order_relaxed);
+
+		uint64_t columns[] = {
+			count,
+			count ? total / count : 0,
+			hist->Percentile(0.5),
+			hist->Percentile(0.9),
+			hist->Percentile(0.99),
+			hist->Percentile(0.999),
+			hist->Max.load(std::memory_order_relaxed)
+		};
+
+		char line[256];
+		size_t length = 0;
+		line[0] = '\0';
+
+		Format::Append(line, sizeof(line), length, hist->Name);
+
+		for (uint64_t column : columns)
+		{
+			Format::Append(line, sizeof(line), length, ",");
+			Format::AppendInteger(line, sizeof(line), length, column);
+		}
+
+		Format::Append(line, sizeof(line), length, "\n");
+		file << line;
+	}
+
+	return true;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "LogBuckets.h"
+
+/* Log-linear latency histogram. Recording is lock-free and wait-free apart from the max. */
+struct Histogram_t
+{
+	static constexpr uint32_t BucketCount = LogBuckets::Count; // Up to ~1100s in ns.
+
+	const char*           Name;
+
+	std::atomic<uint32_t> Buckets[BucketCount] = {};
+	std::atomic<uint64_t> Count                = 0;
+	std::atomic<uint64_t> Total                = 0;
+	std::atomic<uint64_t> Max                  = 0;
+
+	Histogram_t(const char* aName) : Name(aName) {}
+
+	inline void Record(uint64_t aValue)
+	{
+		this->Buckets[LogBuckets::Index(aValue)].fetch_add(1, std::memory_order_relaxed);
+		this->Count.fetch_add(1, std::memory_order_relaxed);
+		this->Total.fetch_add(aValue, std::memory_order_relaxed);
+
+		uint64_t max = this->Max.load(std::memory_order_relaxed);
+		while (aValue > max && !this->Max.compare_exchange_weak(max, aValue, std::memory_order_relaxed)) {}
+	}
+
+	/* Approximate value at the given percentile [0, 1]. */
+	inline uint64_t Percentile(double aPercentile) const
+	{
+		uint64_t count = this->Count.load(std::memory_order_relaxed);
+
+		if (count == 0) { return 0; }
+
+		uint64_t rank = (uint64_t)(aPercentile * count);
+		uint64_t seen = 0;
+
+		for (uint32_t i = 0; i < BucketCount; i++)
+		{
+			seen += this->Buckets[i].load(std::memory_order_relaxed);
+
+			if (seen > rank) { return LogBuckets::Value(i); }
+		}
+
+		return this->Max.load(std::memory_order_relaxed);
+	}
+
+	inline void Reset()
+	{
+		for (std::atomic<uint32_t>& bucket : this->Buckets)
+		{
+			bucket.store(0, std::memory_order_relaxed);
+		}
+
+		this->Count.store(0, std::memory_order_relaxed);
+		this->Total.store(0, std::memory_order_relaxed);
+		this->Max.store(0, std::memory_order_relaxed);
+	}
+};
+
+/* Records the lifetime of the scope in ns into a histogram. */
+struct ScopedTimer_t
+{
+	Histogram_t&                          Target;
+	std::chrono::steady_clock::time_point Start;
+
+	ScopedTimer_t(Histogram_t& aTarget) : Target(aTarget), Start(std::chrono::steady_clock::now()) {}
+
+	~ScopedTimer_t()
+	{
+		this->Target.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->Start).count());
+	}
+};
+
+#define PROFILE_SCOPE(aHistogram) ScopedTimer_t _profileScope(aHistogram)
+
+namespace Profiler
+{
+	extern Histogram_t CombatEvent;
+	extern Histogram_t Advance;
+	extern Histogram_t Render;
+
+	/* All histograms, null-terminated. */
+	extern Histogram_t* All[];
+
+	/* Writes a summary of all histograms to the given file. */
+	bool DumpCSV(const char* aPath);
+}
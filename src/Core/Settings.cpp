@@ -0,0 +1,132 @@
+#include "Settings.h"
+
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+#include "Addon.h"
+#include "Util/src/Strings.h"
+
+#define SETTINGS_FILE "CombatMetrics/settings.cfg"
+
+namespace Settings
+{
+	static AddonAPI_t* s_APIDefs            = nullptr;
+	static std::mutex  s_Mutex;
+
+	std::atomic<uint32_t>     InstanceGracePeriod  = 5000;
+	std::atomic<uint32_t>     HistoryMemoryBudget  = 64;
+	std::atomic<ECaptureMode> CaptureMode          = ECaptureMode::Full;
+	std::atomic<bool>         SpillToDisk          = false;
+	std::atomic<uint32_t>     ActiveTimeGap        = 5000;
+
+	enum class ESettingType
+	{
+		Bool,
+		UInt,
+		Float,
+		CaptureMode
+	};
+
+	struct Setting_t
+	{
+		const char*  Key;
+		ESettingType Type;
+		void*        Value; // std::atomic of the type.
+	};
+
+	static Setting_t s_Settings[] = {
+		{ "InstanceGracePeriod", ESettingType::UInt, &InstanceGracePeriod },
+		{ "HistoryMemoryBudget", ESettingType::UInt, &HistoryMemoryBudget },
+		{ "CaptureMode",         ESettingType::CaptureMode, &CaptureMode },
+		{ "SpillToDisk",         ESettingType::Bool, &SpillToDisk },
+		{ "ActiveTimeGap",       ESettingType::UInt, &ActiveTimeGap }
+	};
+}
+
+void Settings::Load(AddonAPI_t* aApi)
+{
+	s_APIDefs = aApi;
+
+	const std::lock_guard<std::mutex> lock(s_Mutex);
+
+	std::ifstream file(s_APIDefs->Paths_GetAddonDirectory(SETTINGS_FILE));
+
+	if (!file.is_open()) { return; }
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		size_t sep = line.find('=');
+
+		if (sep == std::string::npos) { continue; }
+
+		std::string key   = line.substr(0, sep);
+		std::string value = line.substr(sep + 1);
+
+		for (Setting_t& setting : s_Settings)
+		{
+			if (key != setting.Key) { continue; }
+
+			try
+			{
+				switch (setting.Type)
+				{
+					case ESettingType::Bool:        { ((std::atomic<bool>*)setting.Value)->store(std::stoul(value) != 0);                  break; }
+					case ESettingType::UInt:        { ((std::atomic<uint32_t>*)setting.Value)->store(std::stoul(value));                   break; }
+					case ESettingType::Float:       { ((std::atomic<float>*)setting.Value)->store(std::stof(value));                       break; }
+					case ESettingType::CaptureMode: { ((std::atomic<ECaptureMode>*)setting.Value)->store((ECaptureMode)std::stoul(value)); break; }
+				}
+			}
+			catch (...)
+			{
+				s_APIDefs->Log(LOGL_WARNING, ADDON_NAME, String::Format("Invalid value for setting \"%s\".", setting.Key).c_str());
+			}
+
+			break;
+		}
+	}
+
+	/* Stored as a number, anything unknown falls back to the default. */
+	if ((uint32_t)CaptureMode.load() > (uint32_t)ECaptureMode::Squad)
+	{
+		s_APIDefs->Log(LOGL_WARNING, ADDON_NAME, "Invalid value for setting \"CaptureMode\".");
+		CaptureMode = ECaptureMode::Full;
+	}
+}
+
+void Settings::Save()
+{
+	if (!s_APIDefs) { return; }
+
+	const std::lock_guard<std::mutex> lock(s_Mutex);
+
+	std::filesystem::path path = s_APIDefs->Paths_GetAddonDirectory(SETTINGS_FILE);
+
+	std::error_code ec;
+	std::filesystem::create_directories(path.parent_path(), ec);
+
+	std::ofstream file(path, std::ios::trunc);
+
+	if (!file.is_open())
+	{
+		s_APIDefs->Log(LOGL_WARNING, ADDON_NAME, "Could not write settings.");
+		return;
+	}
+
+	for (const Setting_t& setting : s_Settings)
+	{
+		file << setting.Key << "=";
+
+		switch (setting.Type)
+		{
+			case ESettingType::Bool:        { file << (((std::atomic<bool>*)setting.Value)->load() ? 1 : 0);         break; }
+			case ESettingType::UInt:        { file << ((std::atomic<uint32_t>*)setting.Value)->load();               break; }
+			case ESettingType::Float:       { file << ((std::atomic<float>*)setting.Value)->load();                  break; }
+			case ESettingType::CaptureMode: { file << (uint32_t)((std::atomic<ECaptureMode>*)setting.Value)->load(); break; }
+		}
+
+		file << "\n";
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "Nexus/Nexus.h"
+
+enum class ECaptureMode : uint32_t
+{
+	Full,     // Every health event on the map is stored.
+	SelfOnly, // Only events from or on self and owned minions are stored.
+	Squad     // Like full, additionally accumulates stats for every player.
+};
+
+/* Settings are written by the options UI and read by the hook thread on every
+ * event, they are atomic. No setting is read together with another. */
+namespace Settings
+{
+	void Load(AddonAPI_t* aApi);
+
+	void Save();
+
+	/* Out of combat time in ms after which an encounter ends inside instances. */
+	extern std::atomic<uint32_t> InstanceGracePeriod;
+
+	/* Memory in MB the encounter history may use before old encounters are evicted. */
+	extern std::atomic<uint32_t> HistoryMemoryBudget;
+
+	extern std::atomic<ECaptureMode> CaptureMode;
+
+	/* Whether sealed event chunks of new encounters are written to disk and released. */
+	extern std::atomic<bool> SpillToDisk;
+
+	/* Gap in ms between outgoing hits above which the time does not count as active. */
+	extern std::atomic<uint32_t> ActiveTimeGap;
+}
@@ -0,0 +1,214 @@
+#include "SigCache.h"
+
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Addon.h"
+#include "SigScan.h"
+#include "Version.h"
+#include "Util/src/Strings.h"
+
+#define SIGCACHE_FILE "CombatMetrics/signatures.cfg"
+
+/* Bytes kept of every resolved address to verify it on warm starts. */
+#define SIGCACHE_FINGERPRINT 16
+
+namespace SigCache
+{
+	struct Entry_t
+	{
+		std::string          Name;
+		uint64_t             Offset;      // 0 if the signature was not found.
+		std::vector<uint8_t> Fingerprint; // Bytes at the address when it was resolved.
+	};
+
+	static AddonAPI_t*          s_APIDefs   = nullptr;
+	static std::mutex           s_Mutex;
+
+	static uintptr_t            s_Base      = 0;
+	static uint32_t             s_ImageSize = 0;
+	static std::string          s_BuildID;
+	static std::vector<Entry_t> s_Entries;
+	static bool                 s_IsDirty   = false;
+
+	std::string GetBuildID();
+	std::vector<uint8_t> GetFingerprint(uint64_t aOffset);
+}
+
+std::string SigCache::GetBuildID()
+{
+	/* Link time, image size and checksum identify the game build, the addon
+	 * version is included since it determines the signatures. */
+	const IMAGE_DOS_HEADER* dos = (const IMAGE_DOS_HEADER*)s_Base;
+	const IMAGE_NT_HEADERS* nt  = (const IMAGE_NT_HEADERS*)(s_Base + dos->e_lfanew);
+
+	s_ImageSize = nt->OptionalHeader.SizeOfImage;
+
+	return String::Format("%08X%08X%08X-%u.%u.%u.%u", nt->FileHeader.TimeDateStamp, nt->OptionalHeader.SizeOfImage, nt->OptionalHeader.CheckSum,
+		V_MAJOR, V_MINOR, V_BUILD, V_REVISION);
+}
+
+std::vector<uint8_t> SigCache::GetFingerprint(uint64_t aOffset)
+{
+	size_t length = (size_t)(s_ImageSize - aOffset) < SIGCACHE_FINGERPRINT ? (size_t)(s_ImageSize - aOffset) : SIGCACHE_FINGERPRINT;
+
+	const uint8_t* address = (const uint8_t*)(s_Base + aOffset);
+
+	return std::vector<uint8_t>(address, address + length);
+}
+
+void SigCache::Load(AddonAPI_t* aApi)
+{
+	s_APIDefs = aApi;
+
+	const std::lock_guard<std::mutex> lock(s_Mutex);
+
+	s_Base = (uintptr_t)GetModuleHandleA(nullptr);
+
+	if (!s_Base) { return; }
+
+	s_BuildID = GetBuildID();
+
+	std::ifstream file(s_APIDefs->Paths_GetAddonDirectory(SIGCACHE_FILE));
+
+	if (!file.is_open()) { return; }
+
+	std::string line;
+
+	/* First line is the build the offsets belong to. */
+	if (!std::getline(file, line) || line != "build=" + s_BuildID)
+	{
+		s_APIDefs->Log(LOGL_INFO, ADDON_NAME, "Game or addon build changed, signatures will be rescanned.");
+		s_IsDirty = true;
+		return;
+	}
+
+	while (std::getline(file, line))
+	{
+		size_t sep = line.find('=');
+
+		if (sep == std::string::npos) { continue; }
+
+		/* name=offset:fingerprint, misses have no fingerprint. */
+		size_t colon = line.find(':', sep);
+
+		try
+		{
+			uint64_t offset = std::stoull(line.substr(sep + 1, colon == std::string::npos ? std::string::npos : colon - sep - 1), nullptr, 16);
+
+			if (offset >= s_ImageSize) { continue; }
+
+			Entry_t entry{ line.substr(0, sep), offset };
+
+			if (colon != std::string::npos)
+			{
+				for (size_t i = colon + 1; i + 1 < line.size(); i += 2)
+				{
+					entry.Fingerprint.push_back((uint8_t)std::stoul(line.substr(i, 2), nullptr, 16));
+				}
+			}
+
+			/* Unverifiable addresses are rescanned. */
+			if (offset && entry.Fingerprint.empty()) { continue; }
+
+			s_Entries.push_back(entry);
+		}
+		catch (...)
+		{
+			continue;
+		}
+	}
+}
+
+void SigCache::Save()
+{
+	if (!s_APIDefs) { return; }
+
+	const std::lock_guard<std::mutex> lock(s_Mutex);
+
+	if (!s_IsDirty || s_BuildID.empty()) { return; }
+
+	std::filesystem::path path = s_APIDefs->Paths_GetAddonDirectory(SIGCACHE_FILE);
+
+	std::error_code ec;
+	std::filesystem::create_directories(path.parent_path(), ec);
+
+	std::ofstream file(path, std::ios::trunc);
+
+	if (!file.is_open())
+	{
+		s_APIDefs->Log(LOGL_WARNING, ADDON_NAME, "Could not write signature cache.");
+		return;
+	}
+
+	file << "build=" << s_BuildID << "\n";
+
+	for (const Entry_t& entry : s_Entries)
+	{
+		file << entry.Name << "=" << String::Format("%llX", entry.Offset);
+
+		if (!entry.Fingerprint.empty())
+		{
+			file << ":";
+
+			for (uint8_t byte : entry.Fingerprint)
+			{
+				file << String::Format("%02X", byte);
+			}
+		}
+
+		file << "\n";
+	}
+
+	s_IsDirty = false;
+}
+
+bool SigCache::Get(const char* aName, void** aAddress)
+{
+	const std::lock_guard<std::mutex> lock(s_Mutex);
+
+	for (auto it = s_Entries.begin(); it != s_Entries.end(); it++)
+	{
+		if (it->Name != aName) { continue; }
+
+		if (it->Offset)
+		{
+			/* Same build, but the code at the offset has to be what was scanned. */
+			SigPattern_t fingerprint;
+			fingerprint.Set(it->Fingerprint.data(), it->Fingerprint.size());
+
+			if (it->Fingerprint.size() > s_ImageSize - it->Offset || !fingerprint.MatchesAt((const uint8_t*)(s_Base + it->Offset)))
+			{
+				s_APIDefs->Log(LOGL_WARNING, ADDON_NAME, String::Format("Cached signature \"%s\" does not match, rescanning.", aName).c_str());
+				s_Entries.erase(it);
+				s_IsDirty = true;
+				return false;
+			}
+		}
+
+		*aAddress = it->Offset ? (void*)(s_Base + it->Offset) : nullptr;
+		return true;
+	}
+
+	return false;
+}
+
+void SigCache::Set(const char* aName, void* aAddress)
+{
+	const std::lock_guard<std::mutex> lock(s_Mutex);
+
+	if (!s_Base) { return; }
+
+	uintptr_t address = (uintptr_t)aAddress;
+
+	/* Only offsets inside the game module are stable across runs. */
+	if (address && (address < s_Base || address - s_Base >= s_ImageSize)) { return; }
+
+	uint64_t offset = address ? address - s_Base : 0;
+
+	s_Entries.push_back(Entry_t{ aName, offset, offset ? GetFingerprint(offset) : std::vector<uint8_t>() });
+	s_IsDirty = true;
+}
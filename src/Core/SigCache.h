@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Nexus/Nexus.h"
+
+/* Offsets of resolved signatures relative to the game module, persisted per
+ * game build with a fingerprint of the code so warm starts skip the pattern scans. */
+namespace SigCache
+{
+	/* Reads the cache, entries of a different game build are discarded. */
+	void Load(AddonAPI_t* aApi);
+
+	/* Writes the cache if new entries were resolved. */
+	void Save();
+
+	/* Returns true if the signature was resolved on this build before.
+	 * A known miss returns true with a null address. Cached addresses are
+	 * checked against the bytes seen when they were resolved, on a mismatch
+	 * the entry is dropped and false is returned. */
+	bool Get(const char* aName, void** aAddress);
+
+	void Set(const char* aName, void* aAddress);
+
+	/* Returns the cached address or runs the scan and caches its result. Thread-safe. */
+	template<typename T, typename F>
+	inline T Resolve(const char* aName, F aScan)
+	{
+		void* address = nullptr;
+
+		if (Get(aName, &address)) { return (T)address; }
+
+		T result = aScan();
+		Set(aName, (void*)result);
+
+		return result;
+	}
+}
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define SIGSCAN_SSE2
+#endif
+
+/* Byte pattern with wildcards, parsed from "48 8B ?? 05" style strings. */
+struct SigPattern_t
+{
+	std::vector<uint8_t> Bytes;
+	std::vector<uint8_t> Mask;           // 0xFF where the byte has to match, 0 for wildcards.
+	size_t               Anchor = 0;     // Fixed byte the scan looks for first.
+	const uint8_t*       Result = nullptr;
+
+	/* Returns false on malformed input or a pattern without fixed bytes. */
+	inline bool Parse(const char* aPattern)
+	{
+		this->Bytes.clear();
+		this->Mask.clear();
+		this->Result = nullptr;
+
+		auto hex = [](char aChar) -> int
+		{
+			if (aChar >= '0' && aChar <= '9') { return aChar - '0'; }
+			if (aChar >= 'a' && aChar <= 'f') { return aChar - 'a' + 10; }
+			if (aChar >= 'A' && aChar <= 'F') { return aChar - 'A' + 10; }
+			return -1;
+		};
+
+		for (const char* it = aPattern; *it;)
+		{
+			if (*it == ' ') { it++; continue; }
+
+			if (*it == '?')
+			{
+				it += it[1] == '?' ? 2 : 1;
+				this->Bytes.push_back(0);
+				this->Mask.push_back(0);
+				continue;
+			}
+
+			int high = hex(it[0]);
+			int low  = high < 0 ? -1 : hex(it[1]);
+
+			if (low < 0) { return false; }
+
+			this->Bytes.push_back((uint8_t)(high << 4 | low));
+			this->Mask.push_back(0xFF);
+			it += 2;
+		}
+
+		return this->ChooseAnchor();
+	}
+
+	/* Exact bytes, e.g. a fingerprint of resolved code. */
+	inline void Set(const uint8_t* aBytes, size_t aLength)
+	{
+		this->Bytes.assign(aBytes, aBytes + aLength);
+		this->Mask.assign(aLength, 0xFF);
+		this->Result = nullptr;
+		this->ChooseAnchor();
+	}
+
+	/* Whether the pattern matches at aAddress, which must have Bytes.size() readable bytes. */
+	inline bool MatchesAt(const uint8_t* aAddress) const
+	{
+		for (size_t i = 0; i < this->Bytes.size(); i++)
+		{
+			if ((aAddress[i] & this->Mask[i]) != this->Bytes[i]) { return false; }
+		}
+
+		return true;
+	}
+
+	/* Prologue and prefix bytes are everywhere in x64 code, anchor on a rarer one. */
+	inline bool ChooseAnchor()
+	{
+		static const uint8_t s_Common[] = { 0x00, 0xFF, 0xCC, 0x48, 0x8B, 0x89, 0x4C, 0x24, 0x0F, 0x8D, 0x83, 0xE8, 0x01 };
+
+		bool hasFixed = false;
+
+		for (size_t i = 0; i < this->Bytes.size(); i++)
+		{
+			if (!this->Mask[i]) { continue; }
+
+			if (!hasFixed)
+			{
+				this->Anchor = i;
+				hasFixed = true;
+			}
+
+			if (!std::memchr(s_Common, this->Bytes[i], sizeof(s_Common)))
+			{
+				this->Anchor = i;
+				break;
+			}
+		}
+
+		return hasFixed;
+	}
+};
+
+namespace SigScan
+{
+	/* Visits every position of the image whose byte is set in aAnchors. */
+	template<typename F>
+	inline void ForEachCandidate(const uint8_t* aImage, size_t aSize, const bool* aAnchors, const uint8_t* aAnchorBytes, size_t aAnchorCount, F aCallback)
+	{
+		size_t i = 0;
+
+#if defined(SIGSCAN_SSE2)
+		/* Compare 16 bytes against every anchor byte at once, few anchors keep this cheap. */
+		if (aAnchorCount <= 8)
+		{
+			__m128i needles[8];
+			for (size_t a = 0; a < aAnchorCount; a++)
+			{
+				needles[a] = _mm_set1_epi8((char)aAnchorBytes[a]);
+			}
+
+			for (; i + 16 <= aSize; i += 16)
+			{
+				__m128i block = _mm_loadu_si128((const __m128i*)(aImage + i));
+				__m128i hits  = _mm_setzero_si128();
+
+				for (size_t a = 0; a < aAnchorCount; a++)
+				{
+					hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, needles[a]));
+				}
+
+				uint32_t mask = (uint32_t)_mm_movemask_epi8(hits);
+
+				while (mask)
+				{
+#if defined(_MSC_VER)
+					unsigned long bit;
+					_BitScanForward(&bit, mask);
+#else
+					uint32_t bit = __builtin_ctz(mask);
+#endif
+					if (!aCallback(i + bit)) { return; }
+					mask &= mask - 1;
+				}
+			}
+		}
+#endif
+
+		for (; i < aSize; i++)
+		{
+			if (aAnchors[aImage[i]] && !aCallback(i)) { return; }
+		}
+	}
+
+	/* Resolves the first match of every pattern in a single pass over the image.
+	 * Patterns with a Result already are skipped. Returns the number resolved. */
+	inline size_t ScanAll(const uint8_t* aImage, size_t aSize, SigPattern_t* aPatterns, size_t aCount)
+	{
+		bool    anchors[256]    = {};
+		uint8_t anchorBytes[256];
+		size_t  anchorCount     = 0;
+		size_t  pending         = 0;
+
+		for (size_t p = 0; p < aCount; p++)
+		{
+			const SigPattern_t& pattern = aPatterns[p];
+
+			if (pattern.Result || pattern.Bytes.empty() || pattern.Bytes.size() > aSize) { continue; }
+
+			uint8_t anchor = pattern.Bytes[pattern.Anchor];
+
+			if (!anchors[anchor])
+			{
+				anchors[anchor] = true;
+				anchorBytes[anchorCount++] = anchor;
+			}
+
+			pending++;
+		}
+
+		size_t resolved = 0;
+
+		if (!pending) { return resolved; }
+
+		ForEachCandidate(aImage, aSize, anchors, anchorBytes, anchorCount, [&](size_t aPosition)
+		{
+			uint8_t value = aImage[aPosition];
+
+			for (size_t p = 0; p < aCount; p++)
+			{
+				SigPattern_t& pattern = aPatterns[p];
+
+				if (pattern.Result || pattern.Bytes.empty() || pattern.Bytes[pattern.Anchor] != value) { continue; }
+
+				/* The anchor sits inside the pattern, the match starts before it. */
+				if (aPosition < pattern.Anchor) { continue; }
+
+				size_t start = aPosition - pattern.Anchor;
+
+				if (start + pattern.Bytes.size() > aSize) { continue; }
+
+				if (pattern.MatchesAt(aImage + start))
+				{
+					pattern.Result = aImage + start;
+					resolved++;
+					pending--;
+				}
+			}
+
+			return pending > 0;
+		});
+
+		return resolved;
+	}
+}
@@ -0,0 +1,326 @@
+#include "SpeciesTable.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include "Addon.h"
+#include "Util/src/Strings.h"
+
+#define SPECIESTABLE_FILE           "CombatMetrics/species.cfg"
+#define SPECIESTABLE_READERS        8
+#define SPECIESTABLE_POLL_INTERVAL  1000 // ms between checks of the override file.
+
+namespace SpeciesTable
+{
+	struct Retired_t
+	{
+		const SpeciesTable_t* Table;
+		uint64_t              Epoch;  // Readers pinned before this epoch may still see the table.
+	};
+
+	static AddonAPI_t*                        s_APIDefs   = nullptr;
+	static std::string                        s_Path;
+
+	static std::atomic<const SpeciesTable_t*> s_Table     = nullptr;
+	static std::atomic<uint64_t>              s_Epoch     = 1;
+	static std::atomic<uint64_t>              s_Readers[SPECIESTABLE_READERS] = {}; // Pinned epoch, 0 if free.
+	static std::vector<Retired_t>             s_Retired;  // Watcher thread only.
+
+	static std::thread                        s_Thread;
+	static std::mutex                         s_Mutex;
+	static std::condition_variable            s_Signal;
+	static bool                               s_IsRunning = false;
+
+	const SpeciesTable_t* Build(size_t* aOverrides);
+	bool ParseLine(const std::string& aLine, SpeciesInfo_t& aInfo, bool& aIsIgnored, std::string& aName);
+	void Publish(const SpeciesTable_t* aTable);
+	void Reclaim();
+	void Watch();
+}
+
+const SpeciesInfo_t* SpeciesTable_t::Find(uint32_t aSpeciesID) const
+{
+	auto it = std::lower_bound(this->Entries.begin(), this->Entries.end(), aSpeciesID, [](const SpeciesInfo_t& aInfo, uint32_t aID) {
+		return aInfo.ID < aID;
+	});
+
+	if (it == this->Entries.end() || it->ID != aSpeciesID) { return nullptr; }
+
+	return &*it;
+}
+
+void SpeciesTable::Create(AddonAPI_t* aApi)
+{
+	s_APIDefs = aApi;
+	s_Path = s_APIDefs->Paths_GetAddonDirectory(SPECIESTABLE_FILE);
+
+	size_t overrides = 0;
+	s_Table.store(Build(&overrides));
+
+	if (overrides)
+	{
+		s_APIDefs->Log(LOGL_INFO, ADDON_NAME, String::Format("Loaded %u species overrides.", (uint32_t)overrides).c_str());
+	}
+
+	const std::lock_guard<std::mutex> lock(s_Mutex);
+	if (s_IsRunning) { return; }
+
+	s_IsRunning = true;
+	s_Thread = std::thread(Watch);
+}
+
+void SpeciesTable::Destroy()
+{
+	{
+		const std::lock_guard<std::mutex> lock(s_Mutex);
+		s_IsRunning = false;
+	}
+	s_Signal.notify_all();
+
+	if (s_Thread.joinable())
+	{
+		s_Thread.join();
+	}
+
+	/* Readers still alive keep seeing the last table until they are done. */
+	Publish(nullptr);
+
+	while (!s_Retired.empty())
+	{
+		Reclaim();
+
+		if (!s_Retired.empty())
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+SpeciesTable::Reader_t::Reader_t()
+{
+	for (;;)
+	{
+		for (uint32_t i = 0; i < SPECIESTABLE_READERS; i++)
+		{
+			uint64_t expected = 0;
+
+			if (s_Readers[i].compare_exchange_strong(expected, s_Epoch.load()))
+			{
+				/* Loaded after pinning, a writer that missed the pin has already swapped the table. */
+				this->Slot  = i;
+				this->Table = s_Table.load();
+				return;
+			}
+		}
+
+		std::this_thread::yield();
+	}
+}
+
+SpeciesTable::Reader_t::~Reader_t()
+{
+	s_Readers[this->Slot].store(0);
+}
+
+const SpeciesTable_t* SpeciesTable::Build(size_t* aOverrides)
+{
+	SpeciesTable_t* table = new SpeciesTable_t();
+	table->Entries.assign(std::begin(Species::Table), std::end(Species::Table));
+
+	std::ifstream file(s_Path);
+
+	if (file.is_open())
+	{
+		std::string line;
+		uint32_t lineNo = 0;
+
+		while (std::getline(file, line))
+		{
+			lineNo++;
+
+			if (line.empty() || line[0] == '#' || line[0] == ';') { continue; }
+
+			SpeciesInfo_t info{};
+			bool isIgnored = false;
+			std::string name;
+
+			if (!ParseLine(line, info, isIgnored, name))
+			{
+				s_APIDefs->Log(LOGL_WARNING, ADDON_NAME, String::Format("Ignoring invalid species override on line %u.", lineNo).c_str());
+				continue;
+			}
+
+			auto it = std::find_if(table->Entries.begin(), table->Entries.end(), [&info](const SpeciesInfo_t& aEntry) {
+				return aEntry.ID == info.ID;
+			});
+
+			if (isIgnored)
+			{
+				if (it != table->Entries.end()) { table->Entries.erase(it); }
+			}
+			else
+			{
+				table->Names.push_back(name);
+				info.Name = table->Names.back().c_str();
+
+				if (it != table->Entries.end()) { *it = info; }
+				else                            { table->Entries.push_back(info); }
+			}
+
+			(*aOverrides)++;
+		}
+	}
+
+	std::sort(table->Entries.begin(), table->Entries.end(), [](const SpeciesInfo_t& aLHS, const SpeciesInfo_t& aRHS) {
+		return aLHS.ID < aRHS.ID;
+	});
+
+	return table;
+}
+
+bool SpeciesTable::ParseLine(const std::string& aLine, SpeciesInfo_t& aInfo, bool& aIsIgnored, std::string& aName)
+{
+	static constexpr const char* s_Groups[] = { "Raid", "Wing1", "Wing2", "Wing3", "Wing4", "Wing5", "Wing6", "Wing7", "Wing8", "Fractal", "Strike", "Special", "Golem" };
+
+	size_t sep = aLine.find('=');
+
+	if (sep == std::string::npos) { return false; }
+
+	/* Name is the last column and may contain commas. */
+	std::vector<std::string> columns;
+	size_t pos = sep + 1;
+
+	while (columns.size() < 6)
+	{
+		size_t next = aLine.find(',', pos);
+
+		if (next == std::string::npos) { break; }
+
+		columns.push_back(aLine.substr(pos, next - pos));
+		pos = next + 1;
+	}
+
+	columns.push_back(aLine.substr(pos));
+
+	try
+	{
+		aInfo.ID = (uint32_t)std::stoul(aLine.substr(0, sep));
+	}
+	catch (...)
+	{
+		return false;
+	}
+
+	if (!aInfo.ID) { return false; }
+
+	if (columns.size() >= 2 && columns[1] == "Ignore")
+	{
+		aIsIgnored = true;
+		return true;
+	}
+
+	if (columns.size() < 7) { return false; }
+
+	auto group = std::find(std::begin(s_Groups), std::end(s_Groups), columns[0]);
+
+	if (group == std::end(s_Groups)) { return false; }
+
+	aInfo.Group = (ESpeciesGroup)(group - std::begin(s_Groups));
+
+	if      (columns[1] == "Primary")   { aInfo.Role = ESpeciesRole::Primary; }
+	else if (columns[1] == "Secondary") { aInfo.Role = ESpeciesRole::Secondary; }
+	else                                { return false; }
+
+	try
+	{
+		aInfo.IsCM               = std::stoul(columns[2]) != 0;
+		aInfo.Phases.SpeciesID   = aInfo.ID;
+		aInfo.Phases.TimeGap     = (uint32_t)std::stoul(columns[3]);
+		aInfo.Phases.TargetSwap  = std::stoul(columns[4]) != 0;
+		aInfo.Phases.TargetDeath = std::stoul(columns[5]) != 0;
+	}
+	catch (...)
+	{
+		return false;
+	}
+
+	aName = columns[6];
+
+	return !aName.empty();
+}
+
+void SpeciesTable::Publish(const SpeciesTable_t* aTable)
+{
+	const SpeciesTable_t* prev = s_Table.exchange(aTable);
+
+	if (!prev) { return; }
+
+	/* Readers pinning the new epoch load the pointer after the swap. */
+	s_Retired.push_back(Retired_t{ prev, s_Epoch.fetch_add(1) + 1 });
+
+	Reclaim();
+}
+
+void SpeciesTable::Reclaim()
+{
+	uint64_t oldest = UINT64_MAX;
+
+	for (uint32_t i = 0; i < SPECIESTABLE_READERS; i++)
+	{
+		uint64_t epoch = s_Readers[i].load();
+
+		if (epoch && epoch < oldest) { oldest = epoch; }
+	}
+
+	auto it = std::remove_if(s_Retired.begin(), s_Retired.end(), [oldest](const Retired_t& aRetired) {
+		if (aRetired.Epoch > oldest) { return false; }
+
+		delete aRetired.Table;
+		return true;
+	});
+
+	s_Retired.erase(it, s_Retired.end());
+}
+
+void SpeciesTable::Watch()
+{
+	std::error_code ec;
+	std::filesystem::file_time_type lastWrite = std::filesystem::last_write_time(s_Path, ec);
+
+	std::unique_lock<std::mutex> lock(s_Mutex);
+
+	while (s_IsRunning)
+	{
+		s_Signal.wait_for(lock, std::chrono::milliseconds(SPECIESTABLE_POLL_INTERVAL), [] { return !s_IsRunning; });
+
+		if (!s_IsRunning) { break; }
+
+		lock.unlock();
+
+		std::filesystem::file_time_type write = std::filesystem::last_write_time(s_Path, ec);
+
+		if (ec) { write = std::filesystem::file_time_type::min(); }
+
+		if (write != lastWrite)
+		{
+			lastWrite = write;
+
+			size_t overrides = 0;
+			Publish(Build(&overrides));
+
+			s_APIDefs->Log(LOGL_INFO, ADDON_NAME, String::Format("Reloaded species table, %u overrides.", (uint32_t)overrides).c_str());
+		}
+		else if (!s_Retired.empty())
+		{
+			Reclaim();
+		}
+
+		lock.lock();
+	}
+}
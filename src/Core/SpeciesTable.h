@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "Nexus/Nexus.h"
+#include "Species.h"
+
+/* Built-in species merged with the local overrides, immutable once published. */
+struct SpeciesTable_t
+{
+	std::vector<SpeciesInfo_t> Entries; // Sorted by ID.
+	std::deque<std::string>    Names;   // Storage of override names, stable addresses.
+
+	/* Entry of the species or nullptr. O(log n). */
+	const SpeciesInfo_t* Find(uint32_t aSpeciesID) const;
+};
+
+/* Species table that can be changed at runtime through CombatMetrics/species.cfg.
+ * One line per species, same columns as Species.inl:
+ *   id=Group,Role,IsCM,TimeGap,TargetSwap,TargetDeath,Name
+ * Group is Wing1 to Wing8, Fractal, Strike, Special or Golem, plain Raid is
+ * accepted for raids of unknown wing. Role "Ignore" removes a built-in species. The file is watched and the table
+ * rebuilt off-thread, readers never lock and never see a half-built table. */
+namespace SpeciesTable
+{
+	/* Builds the initial table and starts watching the override file. */
+	void Create(AddonAPI_t* aApi);
+
+	void Destroy();
+
+	/* Pins the current table for the lifetime of the guard, a table swapped
+	 * out meanwhile is only freed once no guard can still see it. Wait-free
+	 * unless every reader slot is taken. */
+	struct Reader_t
+	{
+		uint32_t              Slot;
+		const SpeciesTable_t* Table;
+
+		Reader_t();
+		~Reader_t();
+
+		Reader_t(const Reader_t&) = delete;
+		Reader_t& operator=(const Reader_t&) = delete;
+
+		/* Entry of the species or nullptr. */
+		inline const SpeciesInfo_t* Find(uint32_t aSpeciesID) const
+		{
+			return this->Table ? this->Table->Find(aSpeciesID) : nullptr;
+		}
+	};
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Core/Combat/CbtPhases.h"
+
+enum class ESpeciesGroup : uint8_t
+{
+	Raid,  // Raid of unknown wing, only from overrides.
+	Wing1,
+	Wing2,
+	Wing3,
+	Wing4,
+	Wing5,
+	Wing6,
+	Wing7,
+	Wing8,
+	Fractal,
+	Strike,
+	Special,
+	Golem
+};
+
+enum class ESpeciesRole : uint8_t
+{
+	Primary,  // Starts an encounter and names it.
+	Secondary // Counts as target only.
+};
+
+struct SpeciesInfo_t
+{
+	uint32_t      ID;
+	ESpeciesGroup Group;
+	ESpeciesRole  Role;
+	bool          IsCM;
+	PhaseRule_t   Phases;
+	const char*   Name;   // English, short and without CM suffix. Only names encounters, agents keep their localized name.
+};
+
+/* Built-in species, the data lives in Species.inl. Constant initialized, only
+ * seeds SpeciesTable, lookups go through SpeciesTable so overrides apply. */
+namespace Species
+{
+	inline constexpr SpeciesInfo_t Table[] = {
+#define SPECIES(aID, aGroup, aRole, aIsCM, aTimeGap, aTargetSwap, aTargetDeath, aName) \
+		{ aID, ESpeciesGroup::aGroup, ESpeciesRole::aRole, aIsCM, { aID, aTimeGap, aTargetSwap, aTargetDeath }, aName },
+#include "Species.inl"
+#undef SPECIES
+	};
+
+	inline constexpr size_t Count = sizeof(Table) / sizeof(Table[0]);
+
+	/* Phase rule of species without phase configuration. */
+	inline constexpr PhaseRule_t DefaultPhaseRule = { 0, 0, false, false };
+
+	/* SpeciesTable sorts the entries and looks them up by ID, a duplicate would shadow its twin. */
+	constexpr bool IsUnique()
+	{
+		for (size_t i = 0; i < Count; i++)
+		{
+			for (size_t j = i + 1; j < Count; j++)
+			{
+				if (Table[i].ID == Table[j].ID) { return false; }
+			}
+		}
+
+		return true;
+	}
+
+	static_assert(IsUnique(), "Species are listed more than once in Species.inl.");
+
+	/* Short tag of the group, empty for groups without one. Not translated, "W1" reads the same everywhere. */
+	constexpr const char* GetGroupTag(ESpeciesGroup aGroup)
+	{
+		switch (aGroup)
+		{
+			case ESpeciesGroup::Wing1: return "W1";
+			case ESpeciesGroup::Wing2: return "W2";
+			case ESpeciesGroup::Wing3: return "W3";
+			case ESpeciesGroup::Wing4: return "W4";
+			case ESpeciesGroup::Wing5: return "W5";
+			case ESpeciesGroup::Wing6: return "W6";
+			case ESpeciesGroup::Wing7: return "W7";
+			case ESpeciesGroup::Wing8: return "W8";
+			default:                   return "";
+		}
+	}
+}
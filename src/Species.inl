@@ -0,0 +1,153 @@
+/* Species metadata, compiled into the constexpr tables of Species.h.
+ * Primary species start an encounter, primary and secondary species count as targets.
+ * The phase columns configure the phase split of encounters triggered by the species. */
+
+/*       species, group,   role,      cm,    time gap, target swap, target death, name */
+/* primary - raids */
+SPECIES( 15438,   Wing1,   Primary,   false,  8000,    false,       false,        "Vale Guardian")
+SPECIES( 15429,   Wing1,   Primary,   false,     0,    true,        false,        "Gorseval")
+SPECIES( 15375,   Wing1,   Primary,   false,     0,    true,        false,        "Sabetha")
+SPECIES( 16123,   Wing2,   Primary,   false,     0,    false,       false,        "Slothasor")
+SPECIES( 16088,   Wing2,   Primary,   false,     0,    true,        false,        "Berg")
+SPECIES( 16115,   Wing2,   Primary,   false,     0,    false,       false,        "Matthias")
+SPECIES( 16253,   Wing3,   Primary,   false,     0,    false,       false,        "McLeod the Silent")
+SPECIES( 16235,   Wing3,   Primary,   false,  8000,    false,       false,        "Keep Construct")
+SPECIES( 16247,   Wing3,   Primary,   false,     0,    false,       false,        "Twisted Castle")
+SPECIES( 16246,   Wing3,   Primary,   false,     0,    true,        false,        "Xera")
+SPECIES( 17194,   Wing4,   Primary,   false,     0,    false,       false,        "Cairn")
+SPECIES( 17172,   Wing4,   Primary,   false,     0,    false,       false,        "Mursaat Overseer")
+SPECIES( 17188,   Wing4,   Primary,   false,     0,    true,        false,        "Samarog")
+SPECIES( 17154,   Wing4,   Primary,   false,  8000,    false,       false,        "Deimos")
+SPECIES( 19767,   Wing5,   Primary,   false,     0,    false,       false,        "Soulless Horror")
+SPECIES( 19828,   Wing5,   Primary,   false,     0,    false,       false,        "River of Souls")
+SPECIES( 19691,   Wing5,   Primary,   false,     0,    false,       false,        "Broken King")
+SPECIES( 19536,   Wing5,   Primary,   false,     0,    false,       false,        "Eater of Souls")
+SPECIES( 19844,   Wing5,   Primary,   false,     0,    false,       false,        "Eye of Fate")
+SPECIES( 19450,   Wing5,   Primary,   false, 10000,    false,       false,        "Dhuum")
+SPECIES( 21105,   Wing6,   Primary,   false,     0,    true,        false,        "Nikare")
+SPECIES( 20934,   Wing6,   Primary,   false, 10000,    false,       false,        "Qadim")
+SPECIES( 21964,   Wing7,   Primary,   false,  8000,    false,       false,        "Sabir")
+SPECIES( 22006,   Wing7,   Primary,   false,  8000,    false,       false,        "Adina")
+SPECIES( 22000,   Wing7,   Primary,   false,  8000,    false,       false,        "Qadim the Peerless")
+SPECIES( 26725,   Wing8,   Primary,   false,     0,    true,        false,        "Greer")
+SPECIES( 26774,   Wing8,   Primary,   false,  8000,    false,       false,        "Decima")
+SPECIES( 26867,   Wing8,   Primary,   true,   8000,    false,       false,        "Decima")
+SPECIES( 26712,   Wing8,   Primary,   false,  8000,    false,       false,        "Ura")
+
+/* primary - special */
+SPECIES( 21333,   Special, Primary,   false,     0,    false,       false,        "Freezie")
+
+/* primary - fractals */
+SPECIES( 17021,   Fractal, Primary,   false,  5000,    false,       false,        "MAMA")
+SPECIES( 17028,   Fractal, Primary,   false,  5000,    false,       false,        "Siax")
+SPECIES( 16948,   Fractal, Primary,   false,  5000,    false,       false,        "Ensolyss")
+SPECIES( 17632,   Fractal, Primary,   false,  5000,    false,       true,         "Skorvald")
+SPECIES( 17949,   Fractal, Primary,   false,  5000,    false,       false,        "Artsariiv")
+SPECIES( 17759,   Fractal, Primary,   false,     0,    true,        false,        "Arkk")
+SPECIES( 23254,   Fractal, Primary,   false,     0,    false,       false,        "Sorrowful Spellcaster")
+SPECIES( 25577,   Fractal, Primary,   false,  8000,    false,       false,        "Kanaxai")
+SPECIES( 26231,   Fractal, Primary,   false,  8000,    false,       false,        "Eparch")
+SPECIES( 27010,   Fractal, Primary,   false,     0,    false,       false,        "Whispering Shadow")
+
+/* primary - strike missions */
+SPECIES( 22154,   Strike,  Primary,   false,     0,    false,       false,        "Icebrood Construct")
+SPECIES( 22343,   Strike,  Primary,   false,     0,    true,        false,        "Voice of the Fallen")
+SPECIES( 22492,   Strike,  Primary,   false,     0,    true,        false,        "Fraenir of Jormag")
+SPECIES( 22521,   Strike,  Primary,   false,     0,    false,       false,        "Boneskinner")
+SPECIES( 22711,   Strike,  Primary,   false,     0,    false,       false,        "Whisper of Jormag")
+SPECIES( 24033,   Strike,  Primary,   false,     0,    true,        false,        "Mai Trin")
+SPECIES( 23957,   Strike,  Primary,   false,     0,    false,       false,        "Ankka")
+SPECIES( 24485,   Strike,  Primary,   false,     0,    true,        false,        "Minister Li")
+SPECIES( 24266,   Strike,  Primary,   true,      0,    true,        false,        "Minister Li")
+SPECIES( 25413,   Strike,  Primary,   false,     0,    true,        false,        "Prototype Vermillion")
+SPECIES( 25414,   Strike,  Primary,   true,      0,    true,        false,        "Prototype Vermillion")
+SPECIES( 25705,   Strike,  Primary,   false,  8000,    false,       false,        "Dagda")
+SPECIES( 25989,   Strike,  Primary,   false,  8000,    false,       false,        "Cerus")
+
+/* primary - golems */
+SPECIES( 16199,   Golem,   Primary,   false,     0,    false,       false,        "Standard Kitty Golem")
+SPECIES( 16177,   Golem,   Primary,   false,     0,    false,       false,        "Training Golem")
+SPECIES( 16198,   Golem,   Primary,   false,     0,    false,       false,        "Training Golem")
+SPECIES( 16178,   Golem,   Primary,   false,     0,    false,       false,        "Training Golem")
+SPECIES( 16202,   Golem,   Primary,   false,     0,    false,       false,        "Training Golem")
+SPECIES( 16169,   Golem,   Primary,   false,     0,    false,       false,        "Training Golem")
+SPECIES( 16176,   Golem,   Primary,   false,     0,    false,       false,        "Training Golem")
+SPECIES( 16174,   Golem,   Primary,   false,     0,    false,       false,        "Training Golem")
+SPECIES( 19645,   Golem,   Primary,   false,     0,    false,       false,        "Training Golem")
+SPECIES( 19676,   Golem,   Primary,   false,     0,    false,       false,        "Training Golem")
+
+/* secondary - raids */
+// SPECIES( 15420,   Wing1,   Secondary, false,     0,    false,       false,        "Green Guardian")
+// SPECIES( 15431,   Wing1,   Secondary, false,     0,    false,       false,        "Blue Guardian")
+// SPECIES( 15433,   Wing1,   Secondary, false,     0,    false,       false,        "Red Guardian")
+SPECIES( 15434,   Wing1,   Secondary, false,     0,    false,       false,        "Charged Soul")
+SPECIES( 15372,   Wing1,   Secondary, false,     0,    false,       false,        "Kernan")
+SPECIES( 15404,   Wing1,   Secondary, false,     0,    false,       false,        "Knuckles")
+SPECIES( 15430,   Wing1,   Secondary, false,     0,    false,       false,        "Karde")
+SPECIES( 16125,   Wing2,   Secondary, false,     0,    false,       false,        "Narella")
+SPECIES( 16137,   Wing2,   Secondary, false,     0,    false,       false,        "Zane")
+// SPECIES( 16282,   Wing3,   Secondary, false,     0,    false,       false,        "Caulle")
+// SPECIES( 16274,   Wing3,   Secondary, false,     0,    false,       false,        "Engul")
+// SPECIES( 16264,   Wing3,   Secondary, false,     0,    false,       false,        "Faerla")
+// SPECIES( 16228,   Wing3,   Secondary, false,     0,    false,       false,        "Galletta")
+// SPECIES( 16236,   Wing3,   Secondary, false,     0,    false,       false,        "Henley")
+// SPECIES( 16248,   Wing3,   Secondary, false,     0,    false,       false,        "Ianim")
+// SPECIES( 16278,   Wing3,   Secondary, false,     0,    false,       false,        "Jessica")
+SPECIES( 16286,   Wing3,   Secondary, false,     0,    false,       false,        "Xera (50-0)")
+// SPECIES( 17181,   Wing4,   Secondary, false,     0,    false,       false,        "Jade Scout")
+// SPECIES( 17124,   Wing4,   Secondary, false,     0,    false,       false,        "Rigom")
+SPECIES( 17208,   Wing4,   Secondary, false,     0,    false,       false,        "Guldhem")
+// SPECIES( 19464,   Wing5,   Secondary, false,     0,    false,       false,        "Flesh Wurm")
+// SPECIES( 19801,   Wing5,   Secondary, false,     0,    false,       false,        "Twisted Spirit")
+SPECIES( 19651,   Wing5,   Secondary, false,     0,    false,       false,        "Eye of Judgement")
+// SPECIES( 19681,   Wing5,   Secondary, false,     0,    false,       false,        "Dhuums Enforcer")
+SPECIES( 21089,   Wing6,   Secondary, false,     0,    false,       false,        "Kenut")
+// SPECIES( 21285,   Wing6,   Secondary, false,     0,    false,       false,        "Ancient Invoked Hydra")
+// SPECIES( 21073,   Wing6,   Secondary, false,     0,    false,       false,        "Apocalypse Bringer")
+// SPECIES( 20997,   Wing6,   Secondary, false,     0,    false,       false,        "Wyvern Matriarch")
+// SPECIES( 21183,   Wing6,   Secondary, false,     0,    false,       false,        "Wyvern Patriarch")
+// SPECIES( 21955,   Wing7,   Secondary, true,      0,    false,       false,        "Paralyzing Wisp")
+// SPECIES( 21975,   Wing7,   Secondary, false,     0,    false,       false,        "Voltaic Wisp")
+// SPECIES( 21973,   Wing7,   Secondary, false,     0,    false,       false,        "Entropic Distortion")
+SPECIES( 26771,   Wing8,   Secondary, false,     0,    false,       false,        "Gree")
+SPECIES( 26742,   Wing8,   Secondary, false,     0,    false,       false,        "Reeg")
+// SPECIES( 26859,   Wing8,   Secondary, false,     0,    false,       false,        "Ereg")
+SPECIES( 26862,   Wing8,   Secondary, false,     0,    false,       false,        "Greerling")
+
+/* secondary - strike missions */
+SPECIES( 22315,   Strike,  Secondary, false,     0,    false,       false,        "Voice and Claw of the Fallen")
+SPECIES( 22481,   Strike,  Secondary, false,     0,    false,       false,        "Claw of the Fallen")
+SPECIES( 22436,   Strike,  Secondary, false,     0,    false,       false,        "Icebrood Construct")
+SPECIES( 24431,   Strike,  Secondary, false,     0,    false,       false,        "Scarlet Phantom")
+SPECIES( 25262,   Strike,  Secondary, true,      0,    false,       false,        "Scarlet Phantom")
+SPECIES( 24768,   Strike,  Secondary, false,     0,    false,       false,        "Scarlet")
+SPECIES( 25247,   Strike,  Secondary, true,      0,    false,       false,        "Scarlet")
+SPECIES( 23612,   Strike,  Secondary, false,     0,    false,       false,        "Sniper")
+SPECIES( 24660,   Strike,  Secondary, false,     0,    false,       false,        "Mechrider")
+SPECIES( 24261,   Strike,  Secondary, false,     0,    false,       false,        "Enforcer")
+SPECIES( 23618,   Strike,  Secondary, false,     0,    false,       false,        "Ritualist")
+SPECIES( 24254,   Strike,  Secondary, false,     0,    false,       false,        "Mindblade")
+SPECIES( 25259,   Strike,  Secondary, true,      0,    false,       false,        "Sniper")
+SPECIES( 25271,   Strike,  Secondary, true,      0,    false,       false,        "Mechrider")
+SPECIES( 25236,   Strike,  Secondary, true,      0,    false,       false,        "Enforcer")
+SPECIES( 25242,   Strike,  Secondary, true,      0,    false,       false,        "Ritualist")
+SPECIES( 25280,   Strike,  Secondary, true,      0,    false,       false,        "Mindblade")
+SPECIES( 25415,   Strike,  Secondary, false,     0,    false,       false,        "Prototype Arsenite")
+SPECIES( 25419,   Strike,  Secondary, false,     0,    false,       false,        "Prototype Indigo")
+SPECIES( 25416,   Strike,  Secondary, true,      0,    false,       false,        "Prototype Arsenite")
+SPECIES( 25423,   Strike,  Secondary, true,      0,    false,       false,        "Prototype Indigo")
+
+/* secondary - fractals */
+SPECIES( 17068,   Fractal, Secondary, false,     0,    false,       false,        "Siax")
+SPECIES( 17578,   Fractal, Secondary, false,     0,    false,       false,        "Flux Anomaly")
+SPECIES( 17929,   Fractal, Secondary, false,     0,    false,       false,        "Flux Anomaly")
+SPECIES( 17695,   Fractal, Secondary, false,     0,    false,       false,        "Flux Anomaly")
+SPECIES( 17651,   Fractal, Secondary, false,     0,    false,       false,        "Flux Anomaly")
+SPECIES( 17599,   Fractal, Secondary, false,     0,    false,       false,        "Flux Anomaly")
+SPECIES( 17770,   Fractal, Secondary, false,     0,    false,       false,        "Flux Anomaly")
+SPECIES( 17851,   Fractal, Secondary, false,     0,    false,       false,        "Flux Anomaly")
+SPECIES( 17673,   Fractal, Secondary, false,     0,    false,       false,        "Flux Anomaly")
+SPECIES( 17893,   Fractal, Secondary, false,     0,    false,       false,        "Archdiviner")
+SPECIES( 17730,   Fractal, Secondary, false,     0,    false,       false,        "Gladiator")
+SPECIES( 26270,   Fractal, Secondary, false,     0,    false,       false,        "Cruelty")
+SPECIES( 26260,   Fractal, Secondary, false,     0,    false,       false,        "Judgement")
@@ -1,156 +0,0 @@
-﻿#pragma once
-#include <vector>
-#include <cstdint>
-
-static std::vector<uint32_t> s_PrimaryTargets = {
-/* raids */
-	15438, // vale guardian
-	15429, // gorseval
-	15375, // sabetha
-	16123, // slothasor
-	16088, // trio - berg
-	16115, // matthias
-	16253, // mcleod
-	16235, // keep construct
-	16247, // twisted castle
-	16246, // xera 100-50
-	17194, // cairn
-	17172, // mursaat overseer
-	17188, // samarog
-	17154, // deimos
-	19767, // soulless horror
-	19828, // rainbow road
-	19691, // statues (ice dude)
-	19536, // statues (big dude)
-	19844, // statues (eye of fate)
-	19450, // dhuum
-	21105, // nikare
-	20934, // qadim
-	21964, // sabir
-	22006, // adina
-	22000, // qadim2
-	26725, // greer
-	26774, // decima
-	26867, // decima cm
-	26712, // ura
-
-	/* special */
-	21333, // freezie (wintersday)
-
-	/* fractals */
-	17021, // mama
-	17028, // siax
-	16948, // ensolyss
-	17632, // skorvald
-	17949, // artsariiv
-	17759, // arkk
-	23254, // sorrowful spellcaster
-	25577, // kanaxai
-	26231, // eparch
-	27010, // whispering shadow
-
-	/* strike missions */
-	22154, // icebrood construct
-	22343, // kodan brothers - voice
-	22492, // fraenir
-	22521, // boneskinner
-	22711, // whisper of jormag
-	24033, // mai trin
-	23957, // ankka
-	24485, // minister li
-	24266, // minister li cm
-	25413, // old lions court - prototype vermillion
-	25414, // old lions court cm - prototype vermillion
-	25705, // dagda
-	25989, // cerus
-
-	/* golems/benchmark */
-	16199, // standard kitty golem
-	16177,
-	16198,
-	16178,
-	16202,
-	16169,
-	16176,
-	16174,
-	19645,
-	19676,
-};
-
-static std::vector<uint32_t> s_SecondaryTargets = {
-/* raids */
-	// 15420, // vale guardian - green guardian
-	// 15431, // vale guardian - blue guardian
-	// 15433, // vale guardian - red guardian
-	15434, // gorseval - charged soul
-	15372, // sabetha - kernan
-	15404, // sabetha - knuckles
-	15430, // sabetha - karde
-	16125, // trio - narella
-	16137, // trio - zane
-	// 16282, // keep construct - caulle
-	// 16274, // keep construct - engul
-	// 16264, // keep construct - faerla
-	// 16228, // keep construct - galletta
-	// 16236, // keep construct - henley
-	// 16248, // keep construct - ianim
-	// 16278, // keep construct - jessica
-	16286, // xera 50-0
-	// 17181, // mursaat overseer - jade scout
-	// 17124, // samarog - rigom
-	17208, // samarog - guldhem
-	// 19464, // soulless horror - flesh wurm
-	// 19801, // statues (big dude) - twisted spirit
-	19651, // statues (eye of judgement)
-	// 19681, // dhuum - dhuums enforcer
-	21089, // kenut
-	// 21285, // qadim - ancient invoked hydra
-	// 21073, // qadim - apocalypse bringer
-	// 20997, // qadim - wyvern matriarch
-	// 21183, // qadim - wyvern patriarch
-	// 21955, // sabir - paralyzing wisp cm
-	// 21975, // sabir - voltaic wisp
-	// 21973, // qadim 2 - entropic distortion
-	26771, // gree
-	26742, // reeg
-	// 26859, // ereg
-	26862, // photo-greerling
-
-	/* strike missions */
-	22315, // kodan brothers - merged
-	22481, // kodan brothers - claw
-	22436, // fraenir - construct
-	24431, // mai trin - scarlet phantom
-	25262, // mai trin - scarlet phantom cm
-	24768, // mai trin - scarlet
-	25247, // mai trin - scarlet cm
-	23612, // minister li - sniper
-	24660, // minister li - mechrider
-	24261, // minister li - enforcer
-	23618, // minister li - ritualist
-	24254, // minister li - mindblade
-	25259, // minister li cm - sniper
-	25271, // minister li cm - mechrider
-	25236, // minister li cm - enforcer
-	25242, // minister li cm - ritualist
-	25280, // minister li cm - mindblade
-	25415, // old lions court - prototype arsenite
-	25419, // old lions court - prototype indigo
-	25416, // old lions court cm - prototype arsenite
-	25423, // old lions court cm - prototype indigo
-
-	/* fractals */
-	17068, // nightmare - siax
-	17578, // observatory - flux anomaly
-	17929, // observatory - flux anomaly
-	17695, // observatory - flux anomaly
-	17651, // observatory - flux anomaly
-	17599, // observatory - flux anomaly
-	17770, // observatory - flux anomaly
-	17851, // observatory - flux anomaly
-	17673, // observatory - flux anomaly
-	17893, // observatory - archdiviner
-	17730, // observatory - gladiator
-	26270, // lonely tower - cruelty
-	26260, // lonely tower - judgement
-};
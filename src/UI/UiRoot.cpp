@@ -1,14 +1,23 @@
 #include "UiRoot.h"
 
 #include <algorithm>
+#include <memory>
 #include <mutex>
 
 #include "imgui/imgui.h"
 #include "imgui/imgui_internal.h"
 #include "ImPos/imgui_positioning.h"
 
+#include "Core/Addon.h"
+#include "Core/Combat/CbtEventFeed.h"
 #include "Core/Combat/Combat.h"
+#include "Core/Comparison.h"
+#include "Core/Format.h"
+#include "Core/HistoryIndex.h"
 #include "Core/Localization.h"
+#include "Core/PersonalBest.h"
+#include "Core/Profiler.h"
+#include "Core/Settings.h"
 #include "GW2RE/Game/Map/MapDef.h"
 #include "GW2RE/Game/MissionContext.h"
 #include "GW2RE/Game/PropContext.h"
@@ -26,33 +35,113 @@ namespace UiRoot
 
 	static bool                      s_Incoming           = false;
 
+	static bool                      s_UseTimeWindow      = false;
+	static float                     s_TimeWindow[2]      = {}; // Start and end in seconds since encounter start.
+
+	static bool                      s_SkillsAllHistory   = false;
+
+	/* Bumped whenever an encounter is added to the history, sealed or deleted. */
+	static uint32_t                  s_HistoryGeneration  = 0;
+
+	struct SkillRow_t
+	{
+		Skill_t*       Skill;
+		SkillMetrics_t Metrics;
+	};
+
+	/* Merged skill rows, rebuilt only when the source or the history changes. */
+	static std::vector<SkillRow_t>   s_SkillRows;
+	static HitQuantiles_t            s_SkillTotal;
+	static HitCount_t                s_SkillTotalHits;
+	static const Encounter_t*        s_SkillRowsSource     = nullptr; // nullptr for the whole history.
+	static uint32_t                  s_SkillRowsGeneration = UINT32_MAX;
+
+	/* Buff rows by coverage, rebuilt only when the displayed encounter or the history changes. */
+	static std::vector<const BuffUptime_t*> s_BuffRowsSelf;
+	static std::vector<const BuffUptime_t*> s_BuffRowsTarget;
+	static const Encounter_t*        s_BuffRowsSource      = nullptr;
+	static uint32_t                  s_BuffRowsGeneration  = UINT32_MAX;
+
+	/* Squad rows in table order, sorted again only for a new snapshot or sort order.
+	 * The snapshot is held so the rows never outlive the members they point to. */
+	static std::shared_ptr<const std::vector<SquadMember_t>> s_SquadRowsSource;
+	static std::vector<const SquadMember_t*> s_SquadRows;
+
+	static Encounter_t*              s_CompareWith        = nullptr; // Compared against the displayed encounter.
+
+	struct SearchHit_t
+	{
+		std::shared_ptr<const EncounterSummary_t> Summary;
+		Encounter_t*                              Encounter; // Loaded encounter that matched exactly, nullptr if only on disk.
+	};
+
+	static char                      s_SearchQuery[128]   = {};
+	static std::string               s_SearchLast;
+	static std::vector<SearchHit_t>  s_SearchHits;
+
+	static std::shared_ptr<const PacingCurve_t> s_Pacing;
+	static uint32_t                  s_PacingSpecies      = 0;
+	static uint32_t                  s_PacingGeneration   = 0;
+
 	void OnCombatEvent();
+
+	void EnforceMemoryBudget();
+
+	void RenderSquad();
+
+	void BuildSkillRows();
+	void RenderSkills();
+	void BuildBuffRows();
+	void RenderBuffs();
+
+	void RenderComparison();
+
+	void RenderSearch();
 }
 
-/* Small helper to properly delete collection entries. */
-void DeleteEncounter(Encounter_t* aEncounter)
+/* Frees the encounter and everything it owns, on whichever thread releases it last. */
+static void FreeEncounter(Encounter_t* aEncounter)
 {
-	for (auto [id, ag] : aEncounter->Agents)
+	for (Agent_t* ag : aEncounter->AgentList)
 	{
 		delete ag;
 	}
-	aEncounter->Agents.clear();
+	aEncounter->AgentList.clear();
+	aEncounter->Agents.Clear();
 
-	for (auto [id, sk] : aEncounter->Skills)
+	aEncounter->Skills.ForEach([](uint32_t, Skill_t* aSkill)
 	{
-		delete sk;
-	}
-	aEncounter->Skills.clear();
+		delete aSkill;
+	});
+	aEncounter->Skills.Clear();
 
-	for (auto ev : aEncounter->CombatEvents)
+	for (FlatMap_t<BuffUptime_t*>* buffs : { &aEncounter->BuffsSelf, &aEncounter->BuffsTarget })
 	{
-		delete ev;
+		buffs->ForEach([](uint32_t, BuffUptime_t* aUptime)
+		{
+			delete aUptime;
+		});
+		buffs->Clear();
 	}
-	aEncounter->CombatEvents.clear();
+
+	aEncounter->CombatEvents.Clear();
 
 	delete aEncounter;
 }
 
+/* Small helper to properly delete collection entries. */
+void DeleteEncounter(Encounter_t* aEncounter)
+{
+	/* Cached rows may point into the encounter. */
+	UiRoot::s_HistoryGeneration++;
+
+	/* Undelivered feed records may point at the names. */
+	EventFeed::Invalidate();
+
+	/* Freed right away unless a comparison is reading it, then by the comparison worker. */
+	Comparison::Release(aEncounter, FreeEncounter);
+}
+
 void UiRoot::Create(AddonAPI_t* aApi)
 {
 	s_APIDefs = aApi;
@@ -68,6 +157,8 @@ void UiRoot::Create(AddonAPI_t* aApi)
 	s_NexusLink = static_cast<NexusLinkData_t*>(s_APIDefs->DataLink_Get(DL_NEXUS_LINK));
 
 	s_APIDefs->Events_Subscribe(EV_CMX_COMBAT, (EVENT_CONSUME)OnCombatEvent);
+
+	Comparison::Create();
 }
 
 void UiRoot::Destroy()
@@ -79,12 +170,16 @@ void UiRoot::Destroy()
 	s_APIDefs->GUI_Deregister(UiRoot::Render);
 	s_APIDefs->GUI_Deregister(UiRoot::Options);
 
+	Comparison::Destroy();
+
 	const std::lock_guard<std::mutex> lock(s_Mutex);
 	for (Encounter_t* encounter : s_History)
 	{
 		DeleteEncounter(encounter);
 	}
 	s_History.clear();
+
+	s_SearchHits.clear();
 }
 
 void TooltipGeneric(const char* aFmt, ...)
@@ -102,8 +197,40 @@ void TooltipGeneric(const char* aFmt, ...)
 	}
 }
 
+/* Per second rate of a value, "-/s" if there is none. */
+char* FormatRate(char* aBuffer, size_t aSize, bool aHasValue, float aValue, float aDuration)
+{
+	if (!aHasValue)
+	{
+		return Format::Join(aBuffer, aSize, "-/s", "");
+	}
+
+	return Format::Denominated(aBuffer, aSize, aValue / aDuration, "/s");
+}
+
+/* Damage tooltip, with hit details when the metrics of the whole encounter are shown. */
+void TooltipDamage(float aDamage, const char* aDuration, const EncounterMetrics_t* aMetrics)
+{
+	if (!ImGui::IsItemHovered()) { return; }
+
+	ImGui::BeginTooltip();
+	ImGui::Text("%.0f, %s", abs(aDamage), aDuration);
+
+	if (aMetrics && aMetrics->Hits > 0)
+	{
+		ImGui::Separator();
+		ImGui::Text("%s: %u, %s: %.1f%%", Translate(ETexts::Hits), aMetrics->Hits, Translate(ETexts::CritRate), aMetrics->CritRate() * 100.f);
+		ImGui::Text("%s: %.0f, %s: %.0f", Translate(ETexts::Power), abs(aMetrics->Power), Translate(ETexts::Condition), abs(aMetrics->Condition));
+		ImGui::Text("%s: %.0f - %.0f", Translate(ETexts::HitRange), aMetrics->MinHit, aMetrics->MaxHit);
+	}
+
+	ImGui::EndTooltip();
+}
+
 void UiRoot::Render()
 {
+	PROFILE_SCOPE(Profiler::Render);
+
 	if (!s_NexusLink || !s_NexusLink->IsGameplay)
 	{
 		return;
@@ -112,8 +239,8 @@ void UiRoot::Render()
 	GW2RE::CPropContext propctx = GW2RE::CPropContext::Get();
 	GW2RE::MissionContext_t* missionctx = propctx.GetMissionCtx();
 
-	std::string wndName = Translate(ETexts::CombatMetrics);
-	wndName.append("###CMX::Metrics");
+	char wndName[128];
+	Format::Join(wndName, sizeof(wndName), Translate(ETexts::CombatMetrics), "###CMX::Metrics");
 
 	static ImGuiExt::Positioning_t s_Position{};
 
@@ -121,7 +248,7 @@ void UiRoot::Render()
 
 	if (missionctx && missionctx->CurrentMap && missionctx->CurrentMap->PvP)
 	{
-		ImGui::Begin(wndName.c_str(), 0, wndFlags);
+		ImGui::Begin(wndName, 0, wndFlags);
 		ImGui::TextColored(ImVec4(0.675f, 0.349f, 0.349f, 1.0f), Translate(ETexts::DisabledInPvP));
 		ImGui::End();
 		return;
@@ -134,25 +261,67 @@ void UiRoot::Render()
 
 	if (!Combat::IsRegistered())
 	{
-		ImGui::Begin(wndName.c_str(), 0, wndFlags);
+		ImGui::Begin(wndName, 0, wndFlags);
 		ImGui::TextColored(ImVec4(0.675f, 0.349f, 0.349f, 1.0f), Translate(ETexts::DisabledCombatTracker));
 		ImGui::End();
 		return;
 	}
 
 	const std::lock_guard<std::mutex> lock(s_Mutex);
-	if (ImGui::Begin(wndName.c_str(), 0, wndFlags))
+	if (ImGui::Begin(wndName, 0, wndFlags))
 	{
 		uint64_t cbtDurationMs = max(s_DisplayedEncounter->TimeEnd - s_DisplayedEncounter->TimeStart, 1000);
 		float cbtDuration = cbtDurationMs / 1000.f;
 
-		std::string durationStr = s_DisplayedEncounter->Duration();
+		char durationStr[48];
+		s_DisplayedEncounter->Duration(durationStr, sizeof(durationStr));
+
+		/* Active time only applies to outgoing damage of the whole encounter. */
+		bool showActive = !s_Incoming;
+		uint64_t activeDurationMs = s_DisplayedEncounter->ActiveDurationMs(Settings::ActiveTimeGap);
+
+		Stats_t statsTarget = s_Incoming ? s_DisplayedEncounter->InTarget : s_DisplayedEncounter->OutTarget;
+		Stats_t statsCleave = s_Incoming ? s_DisplayedEncounter->InCleave : s_DisplayedEncounter->OutCleave;
+
+		const EncounterMetrics_t* metricsTarget = s_Incoming ? &s_DisplayedEncounter->InTarget : &s_DisplayedEncounter->OutTarget;
+		const EncounterMetrics_t* metricsCleave = s_Incoming ? &s_DisplayedEncounter->InCleave : &s_DisplayedEncounter->OutCleave;
+
+		/* Time window queries are only answered from sealed indices. */
+		if (s_UseTimeWindow && s_DisplayedEncounter->OutCleaveIndex.IsFinalized)
+		{
+			/* Rounded, phase bounds are exact ms and must not slip into the neighbouring phase. */
+			uint32_t windowStart = (uint32_t)(s_TimeWindow[0] * 1000 + 0.5f);
+			uint32_t windowEnd   = (uint32_t)(s_TimeWindow[1] * 1000 + 0.5f);
+
+			const TimeIndex_t& idxTarget = s_Incoming ? s_DisplayedEncounter->InTargetIndex : s_DisplayedEncounter->OutTargetIndex;
+			const TimeIndex_t& idxCleave = s_Incoming ? s_DisplayedEncounter->InCleaveIndex : s_DisplayedEncounter->OutCleaveIndex;
+
+			statsTarget = idxTarget.Query(windowStart, windowEnd);
+			statsCleave = idxCleave.Query(windowStart, windowEnd);
+
+			/* Hit metrics are not indexed by time. */
+			metricsTarget = nullptr;
+			metricsCleave = nullptr;
+
+			cbtDurationMs = max(windowEnd - windowStart, 1000);
+			cbtDuration = cbtDurationMs / 1000.f;
+
+			size_t length = 0;
+			durationStr[0] = '\0';
+			Format::AppendNumber(durationStr, sizeof(durationStr), length, s_TimeWindow[0], 2);
+			Format::Append(durationStr, sizeof(durationStr), length, "s - ");
+			Format::AppendNumber(durationStr, sizeof(durationStr), length, s_TimeWindow[1], 2);
+			Format::Append(durationStr, sizeof(durationStr), length, "s");
+
+			showActive = false;
+		}
 
 		if (ImGui::BeginTable("Data", 3))
 		{
+			char header[64];
 			ImGui::TableSetupColumn("##NULL", ImGuiTableColumnFlags_WidthStretch);
-			ImGui::TableSetupColumn((std::string(Translate(ETexts::Target)) + "##Target").c_str(), ImGuiTableColumnFlags_WidthStretch);
-			ImGui::TableSetupColumn((std::string(Translate(ETexts::Cleave)) + "##Cleave").c_str(), ImGuiTableColumnFlags_WidthStretch);
+			ImGui::TableSetupColumn(Format::Join(header, sizeof(header), Translate(ETexts::Target), "##Target"), ImGuiTableColumnFlags_WidthStretch);
+			ImGui::TableSetupColumn(Format::Join(header, sizeof(header), Translate(ETexts::Cleave), "##Cleave"), ImGuiTableColumnFlags_WidthStretch);
 			ImGui::TableHeadersRow();
 			/* TODO: Configurable headers. */
 
@@ -161,32 +330,49 @@ void UiRoot::Render()
 			ImGui::TableNextColumn();
 			ImGui::TextDisabled(Translate(ETexts::Damage));
 
-			float* damageCleave = s_Incoming ? &s_DisplayedEncounter->InCleave.Damage : &s_DisplayedEncounter->OutCleave.Damage;
-			float* damageTarget = s_Incoming ? &s_DisplayedEncounter->InTarget.Damage : &s_DisplayedEncounter->OutTarget.Damage;
-
-			float* healCleave = s_Incoming ? &s_DisplayedEncounter->InCleave.Heal : &s_DisplayedEncounter->OutCleave.Heal;
-			float* healTarget = s_Incoming ? &s_DisplayedEncounter->InTarget.Heal : &s_DisplayedEncounter->OutTarget.Heal;
-
-			float* barrierCleave = s_Incoming ? &s_DisplayedEncounter->InCleave.Barrier : &s_DisplayedEncounter->OutCleave.Barrier;
-			float* barrierTarget = s_Incoming ? &s_DisplayedEncounter->InTarget.Barrier : &s_DisplayedEncounter->OutTarget.Barrier;
-
 			/* DPS Target */
 			ImGui::TableNextColumn();
-			std::string dpsTarget = *damageTarget < 0.f
-				? String::FormatNumberDenominated(abs(*damageTarget) / cbtDuration) + "/s"
-				: "-/s";
-			ImGui::SetCursorPosX(ImGui::GetCursorPosX() + ImGui::GetColumnWidth() - ImGui::CalcTextSize(dpsTarget.c_str()).x);
-			ImGui::Text(dpsTarget.c_str());
-			TooltipGeneric("%.0f, %s", abs(*damageTarget), durationStr.c_str());
+			char dpsTarget[32];
+			FormatRate(dpsTarget, sizeof(dpsTarget), statsTarget.Damage < 0.f, abs(statsTarget.Damage), cbtDuration);
+			ImGui::SetCursorPosX(ImGui::GetCursorPosX() + ImGui::GetColumnWidth() - ImGui::CalcTextSize(dpsTarget).x);
+			ImGui::Text(dpsTarget);
+			TooltipDamage(statsTarget.Damage, durationStr, metricsTarget);
 
 			/* DPS Cleave */
 			ImGui::TableNextColumn();
-			std::string dpsCleave = *damageCleave < 0.f
-				? String::FormatNumberDenominated(abs(*damageCleave) / cbtDuration) + "/s"
-				: "-/s";
-			ImGui::SetCursorPosX(ImGui::GetCursorPosX() + ImGui::GetColumnWidth() - ImGui::CalcTextSize(dpsCleave.c_str()).x);
-			ImGui::Text(dpsCleave.c_str());
-			TooltipGeneric("%.0f, %s", abs(*damageCleave), durationStr.c_str());
+			char dpsCleave[32];
+			FormatRate(dpsCleave, sizeof(dpsCleave), statsCleave.Damage < 0.f, abs(statsCleave.Damage), cbtDuration);
+			ImGui::SetCursorPosX(ImGui::GetCursorPosX() + ImGui::GetColumnWidth() - ImGui::CalcTextSize(dpsCleave).x);
+			ImGui::Text(dpsCleave);
+			TooltipDamage(statsCleave.Damage, durationStr, metricsCleave);
+
+			if (showActive)
+			{
+				float activeDuration = activeDurationMs / 1000.f;
+				char activeStr[32];
+				Format::Duration(activeStr, sizeof(activeStr), activeDurationMs);
+
+				/* Active row. */
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::TextDisabled(Translate(ETexts::ActiveTime));
+
+				/* Active DPS Target */
+				ImGui::TableNextColumn();
+				char adpsTarget[32];
+				FormatRate(adpsTarget, sizeof(adpsTarget), statsTarget.Damage < 0.f, abs(statsTarget.Damage), activeDuration);
+				ImGui::SetCursorPosX(ImGui::GetCursorPosX() + ImGui::GetColumnWidth() - ImGui::CalcTextSize(adpsTarget).x);
+				ImGui::Text(adpsTarget);
+				TooltipGeneric("%.0f, %s / %s", abs(statsTarget.Damage), activeStr, durationStr);
+
+				/* Active DPS Cleave */
+				ImGui::TableNextColumn();
+				char adpsCleave[32];
+				FormatRate(adpsCleave, sizeof(adpsCleave), statsCleave.Damage < 0.f, abs(statsCleave.Damage), activeDuration);
+				ImGui::SetCursorPosX(ImGui::GetCursorPosX() + ImGui::GetColumnWidth() - ImGui::CalcTextSize(adpsCleave).x);
+				ImGui::Text(adpsCleave);
+				TooltipGeneric("%.0f, %s / %s", abs(statsCleave.Damage), activeStr, durationStr);
+			}
 
 			/* Heal row. */
 			ImGui::TableNextRow();
@@ -195,21 +381,19 @@ void UiRoot::Render()
 
 			/* Heal Target */
 			ImGui::TableNextColumn();
-			std::string hpsTarget = *healTarget > 0.f
-				? String::FormatNumberDenominated(*healTarget / cbtDuration) + "/s"
-				: "-/s";
-			ImGui::SetCursorPosX(ImGui::GetCursorPosX() + ImGui::GetColumnWidth() - ImGui::CalcTextSize(hpsTarget.c_str()).x);
-			ImGui::Text(hpsTarget.c_str());
-			TooltipGeneric("%.0f, %s", *healTarget, durationStr.c_str());
+			char hpsTarget[32];
+			FormatRate(hpsTarget, sizeof(hpsTarget), statsTarget.Heal > 0.f, statsTarget.Heal, cbtDuration);
+			ImGui::SetCursorPosX(ImGui::GetCursorPosX() + ImGui::GetColumnWidth() - ImGui::CalcTextSize(hpsTarget).x);
+			ImGui::Text(hpsTarget);
+			TooltipGeneric("%.0f, %s", statsTarget.Heal, durationStr);
 
 			/* Heal Cleave */
 			ImGui::TableNextColumn();
-			std::string hpsCleave = *healCleave > 0.f
-				? String::FormatNumberDenominated(*healCleave / cbtDuration) + "/s"
-				: "-/s";
-			ImGui::SetCursorPosX(ImGui::GetCursorPosX() + ImGui::GetColumnWidth() - ImGui::CalcTextSize(hpsCleave.c_str()).x);
-			ImGui::Text(hpsCleave.c_str());
-			TooltipGeneric("%.0f, %s", *healCleave, durationStr.c_str());
+			char hpsCleave[32];
+			FormatRate(hpsCleave, sizeof(hpsCleave), statsCleave.Heal > 0.f, statsCleave.Heal, cbtDuration);
+			ImGui::SetCursorPosX(ImGui::GetCursorPosX() + ImGui::GetColumnWidth() - ImGui::CalcTextSize(hpsCleave).x);
+			ImGui::Text(hpsCleave);
+			TooltipGeneric("%.0f, %s", statsCleave.Heal, durationStr);
 
 			/* Barrier row. */
 			ImGui::TableNextRow();
@@ -218,23 +402,72 @@ void UiRoot::Render()
 
 			/* Barrier Target */
 			ImGui::TableNextColumn();
-			std::string bpsTarget = *barrierTarget > 0.f
-				? String::FormatNumberDenominated(*barrierTarget / cbtDuration) + "/s"
-				: "-/s";
-			ImGui::SetCursorPosX(ImGui::GetCursorPosX() + ImGui::GetColumnWidth() - ImGui::CalcTextSize(bpsTarget.c_str()).x);
-			ImGui::Text(bpsTarget.c_str());
-			TooltipGeneric("%.0f, %s", *barrierTarget, durationStr.c_str());
+			char bpsTarget[32];
+			FormatRate(bpsTarget, sizeof(bpsTarget), statsTarget.Barrier > 0.f, statsTarget.Barrier, cbtDuration);
+			ImGui::SetCursorPosX(ImGui::GetCursorPosX() + ImGui::GetColumnWidth() - ImGui::CalcTextSize(bpsTarget).x);
+			ImGui::Text(bpsTarget);
+			TooltipGeneric("%.0f, %s", statsTarget.Barrier, durationStr);
 
 			/* Barrier Cleave*/
 			ImGui::TableNextColumn();
-			std::string bpsCleave = *barrierCleave > 0.f
-				? String::FormatNumberDenominated(*barrierCleave / cbtDuration) + "/s"
-				: "-/s";
-			ImGui::SetCursorPosX(ImGui::GetCursorPosX() + ImGui::GetColumnWidth() - ImGui::CalcTextSize(bpsCleave.c_str()).x);
-			ImGui::Text(bpsCleave.c_str());
-			TooltipGeneric("%.0f, %s", *barrierCleave, durationStr.c_str());
+			char bpsCleave[32];
+			FormatRate(bpsCleave, sizeof(bpsCleave), statsCleave.Barrier > 0.f, statsCleave.Barrier, cbtDuration);
+			ImGui::SetCursorPosX(ImGui::GetCursorPosX() + ImGui::GetColumnWidth() - ImGui::CalcTextSize(bpsCleave).x);
+			ImGui::Text(bpsCleave);
+			TooltipGeneric("%.0f, %s", statsCleave.Barrier, durationStr);
 		}
 		ImGui::EndTable();
+
+		/* Pacing against the personal best kill of the trigger species. */
+		if (!s_Incoming && s_DisplayedEncounter->SpeciesID)
+		{
+			uint32_t generation = PersonalBest::GetGeneration();
+
+			if (s_PacingSpecies != s_DisplayedEncounter->SpeciesID || s_PacingGeneration != generation)
+			{
+				s_Pacing           = PersonalBest::Get(s_DisplayedEncounter->SpeciesID);
+				s_PacingSpecies    = s_DisplayedEncounter->SpeciesID;
+				s_PacingGeneration = generation;
+			}
+
+			if (s_Pacing)
+			{
+				uint32_t elapsed = (uint32_t)(s_DisplayedEncounter->TimeEnd - s_DisplayedEncounter->TimeStart);
+				float    delta   = abs(s_DisplayedEncounter->OutTarget.Damage) - s_Pacing->At(elapsed);
+
+				char deltaStr[32];
+				Format::Denominated(deltaStr, sizeof(deltaStr), abs(delta));
+
+				ImGui::TextDisabled(Translate(ETexts::PersonalBest));
+				ImGui::SameLine();
+				ImGui::TextColored(delta >= 0.f ? ImVec4(0.f, 1.f, 0.f, 1.f) : ImVec4(1.f, 0.f, 0.f, 1.f),
+					"%s%s", delta >= 0.f ? "+" : "-", deltaStr);
+				TooltipGeneric("%.0f, %.2fs", s_Pacing->At(elapsed), s_Pacing->Duration / 1000.f);
+			}
+		}
+
+		/* Time spent downed and dead, within the time window if one is set. */
+		if (s_DisplayedEncounter->OutCleaveIndex.IsFinalized && s_DisplayedEncounter->Self)
+		{
+			const StateTimeline_t& states = s_DisplayedEncounter->Self->States;
+
+			uint32_t rangeStart = 0;
+			uint32_t rangeEnd   = (uint32_t)(s_DisplayedEncounter->TimeEnd - s_DisplayedEncounter->TimeStart);
+
+			if (s_UseTimeWindow)
+			{
+				rangeStart = (uint32_t)(s_TimeWindow[0] * 1000 + 0.5f);
+				rangeEnd   = (uint32_t)(s_TimeWindow[1] * 1000 + 0.5f);
+			}
+
+			uint32_t downed = states.TimeIn(EAgentState::Downed, rangeStart, rangeEnd);
+			uint32_t dead   = states.TimeIn(EAgentState::Dead, rangeStart, rangeEnd);
+
+			if (downed || dead)
+			{
+				ImGui::TextDisabled("%s %.1fs, %s %.1fs", Translate(ETexts::Downed), downed / 1000.f, Translate(ETexts::Dead), dead / 1000.f);
+			}
+		}
 	}
 
 	if (ImGui::BeginPopupContextWindow("###CMX::Metrics::CtxMenu", ImGuiPopupFlags_MouseButtonRight))
@@ -244,17 +477,167 @@ void UiRoot::Render()
 			s_Incoming = !s_Incoming;
 		}
 
+		if (s_DisplayedEncounter->OutCleaveIndex.IsFinalized)
+		{
+			float maxTime = (s_DisplayedEncounter->TimeEnd - s_DisplayedEncounter->TimeStart) / 1000.f;
+
+			ImGui::Checkbox(Translate(ETexts::TimeWindow), &s_UseTimeWindow);
+
+			if (s_UseTimeWindow)
+			{
+				ImGui::DragFloatRange2("##TimeWindow", &s_TimeWindow[0], &s_TimeWindow[1], 0.25f, 0.f, maxTime, "%.1fs", "%.1fs", ImGuiSliderFlags_AlwaysClamp);
+			}
+		}
+
+		if (s_DisplayedEncounter->OutCleaveIndex.IsFinalized && s_DisplayedEncounter->Phases.Phases.size() > 1)
+		{
+			if (ImGui::BeginMenu(Translate(ETexts::Phases)))
+			{
+				const std::vector<Phase_t>& phases = s_DisplayedEncounter->Phases.Phases;
+
+				for (size_t i = 0; i < phases.size(); i++)
+				{
+					const Phase_t& phase = phases[i];
+
+					float phaseStart = phase.TimeStart / 1000.f;
+					float phaseEnd   = phase.TimeEnd / 1000.f;
+
+					char label[64];
+					size_t length = 0;
+					label[0] = '\0';
+					Format::AppendInteger(label, sizeof(label), length, i + 1);
+					Format::Append(label, sizeof(label), length, ": ");
+					Format::AppendNumber(label, sizeof(label), length, phaseStart, 1);
+					Format::Append(label, sizeof(label), length, "s - ");
+					Format::AppendNumber(label, sizeof(label), length, phaseEnd, 1);
+					Format::Append(label, sizeof(label), length, "s##Phase");
+					Format::AppendInteger(label, sizeof(label), length, i);
+
+					if (ImGui::Selectable(label))
+					{
+						/* Selecting a phase narrows the time window to it. */
+						s_UseTimeWindow = true;
+						s_TimeWindow[0] = phaseStart;
+						s_TimeWindow[1] = phaseEnd;
+					}
+
+					const Stats_t& phaseStats = s_Incoming ? phase.InTarget : phase.OutTarget;
+					TooltipGeneric("%.0f, %.2fs", abs(phaseStats.Damage), max(phaseEnd - phaseStart, 1.f));
+				}
+
+				ImGui::EndMenu();
+			}
+		}
+
+		/* Skill metrics are only read once the ingest is done with them. */
+		if (s_DisplayedEncounter->OutCleaveIndex.IsFinalized && ImGui::BeginMenu(Translate(ETexts::Skills)))
+		{
+			ImGui::Checkbox(Translate(ETexts::WholeHistory), &s_SkillsAllHistory);
+
+			RenderSkills();
+
+			ImGui::EndMenu();
+		}
+
+		/* Buff uptimes are closed on combat end. */
+		if (s_DisplayedEncounter->OutCleaveIndex.IsFinalized && ImGui::BeginMenu(Translate(ETexts::Buffs)))
+		{
+			RenderBuffs();
+
+			ImGui::EndMenu();
+		}
+
+		std::shared_ptr<const DeathRecap_t> recap = std::atomic_load(&s_DisplayedEncounter->Recap);
+
+		if (recap && ImGui::BeginMenu(Translate(ETexts::DeathRecap)))
+		{
+			/* The ring overflowed within the window, the oldest hits are missing. */
+			if (recap->IsTruncated)
+			{
+				ImGui::TextDisabled(Translate(ETexts::RecapTruncated));
+			}
+
+			if (ImGui::BeginTable("Recap", 4))
+			{
+				char name[32];
+
+				for (uint32_t i = 0; i < recap->Count; i++)
+				{
+					const RecapHit_t& hit = recap->Hits[i];
+
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					ImGui::TextDisabled("-%.1fs", (recap->Time - hit.Time) / 1000.f);
+					ImGui::TableNextColumn();
+					ImGui::Text(hit.SrcAgent ? hit.SrcAgent->GetName(name, sizeof(name)) : "(null)");
+					ImGui::TableNextColumn();
+					ImGui::Text(hit.Skill ? hit.Skill->GetName(name, sizeof(name)) : "(null)");
+					ImGui::TableNextColumn();
+					ImGui::Text("%.0f", abs(hit.Value));
+				}
+
+				ImGui::EndTable();
+			}
+
+			ImGui::EndMenu();
+		}
+
+		/* Sealed encounters only, the diff is computed in the background. */
+		if (s_DisplayedEncounter->OutCleaveIndex.IsFinalized && ImGui::BeginMenu(Translate(ETexts::Compare)))
+		{
+			char name[192];
+
+			for (int32_t i = s_History.size() - 1; i >= 0; i--)
+			{
+				Encounter_t* encounter = s_History[i];
+
+				if (encounter == s_DisplayedEncounter || !encounter->OutCleaveIndex.IsFinalized) { continue; }
+
+				bool isSameSpecies = encounter->SpeciesID && encounter->SpeciesID == s_DisplayedEncounter->SpeciesID;
+
+				if (ImGui::Selectable(encounter->GetName(name, sizeof(name)), encounter == s_CompareWith))
+				{
+					s_CompareWith = encounter;
+				}
+
+				if (isSameSpecies)
+				{
+					ImGui::SameLine();
+					ImGui::TextDisabled("*");
+				}
+			}
+
+			ImGui::EndMenu();
+		}
+
+		if (ImGui::BeginMenu(Translate(ETexts::Search)))
+		{
+			RenderSearch();
+
+			ImGui::EndMenu();
+		}
+
 		if (ImGui::BeginMenu("History"))
 		{
 			if (s_History.size() > 0)
 			{
+				char name[192];
+
 				for (int32_t i = s_History.size() - 1; i >= 0; i--)
 				{
 					Encounter_t* encounter = s_History[i];
 
-					if (ImGui::Selectable(i == s_History.size() - 1 ? "Current" : encounter->GetName().c_str()))
+					/* The live encounter is not named, its agent map is still written to. */
+					bool isLive = i == s_History.size() - 1 || !encounter->OutCleaveIndex.IsFinalized;
+
+					if (ImGui::Selectable(isLive ? "Current" : encounter->GetName(name, sizeof(name))))
 					{
 						s_DisplayedEncounter = encounter;
+						s_DisplayedEncounter->LastAccess = GetTickCount64();
+
+						/* Default the window to the full encounter. */
+						s_TimeWindow[0] = 0.f;
+						s_TimeWindow[1] = (encounter->TimeEnd - encounter->TimeStart) / 1000.f;
 					}
 				}
 			}
@@ -272,29 +655,576 @@ void UiRoot::Render()
 	ImGuiExt::ContextMenuPosition("###CMX::Metrics::CtxMenu");
 
 	ImGui::End();
+
+	if (Settings::CaptureMode == ECaptureMode::Squad)
+	{
+		RenderSquad();
+	}
+
+	if (s_CompareWith)
+	{
+		RenderComparison();
+	}
 }
 
-void UiRoot::Options()
+void UiRoot::RenderSquad()
 {
-	
+	std::shared_ptr<const std::vector<SquadMember_t>> squad = std::atomic_load(&s_DisplayedEncounter->Squad);
+
+	char wndName[128];
+	Format::Join(wndName, sizeof(wndName), Translate(ETexts::Squad), "###CMX::Squad");
+
+	if (ImGui::Begin(wndName, 0, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoCollapse))
+	{
+		if (!squad || squad->empty())
+		{
+			ImGui::TextDisabled(Translate(ETexts::NoTargets));
+		}
+		else if (ImGui::BeginTable("Squad", 5, ImGuiTableFlags_Sortable | ImGuiTableFlags_RowBg))
+		{
+			float cbtDuration = max(s_DisplayedEncounter->TimeEnd - s_DisplayedEncounter->TimeStart, 1000) / 1000.f;
+
+			char header[64];
+			ImGui::TableSetupColumn("##Name", ImGuiTableColumnFlags_WidthStretch | ImGuiTableColumnFlags_NoSort);
+			ImGui::TableSetupColumn(Format::Join(header, sizeof(header), Translate(ETexts::Target), "##Target"), ImGuiTableColumnFlags_WidthStretch | ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_PreferSortDescending);
+			ImGui::TableSetupColumn(Format::Join(header, sizeof(header), Translate(ETexts::Cleave), "##Cleave"), ImGuiTableColumnFlags_WidthStretch | ImGuiTableColumnFlags_PreferSortDescending);
+			ImGui::TableSetupColumn(Format::Join(header, sizeof(header), Translate(ETexts::Heal), "##Heal"), ImGuiTableColumnFlags_WidthStretch | ImGuiTableColumnFlags_PreferSortDescending);
+			ImGui::TableSetupColumn(Format::Join(header, sizeof(header), Translate(ETexts::Barrier), "##Barrier"), ImGuiTableColumnFlags_WidthStretch | ImGuiTableColumnFlags_PreferSortDescending);
+			ImGui::TableHeadersRow();
+
+			bool isNewSnapshot = squad != s_SquadRowsSource;
+
+			/* The snapshot is shared with the ingest, the rows only point into it. */
+			if (isNewSnapshot)
+			{
+				s_SquadRowsSource = squad;
+				s_SquadRows.clear();
+
+				for (const SquadMember_t& member : *squad)
+				{
+					s_SquadRows.push_back(&member);
+				}
+			}
+
+			ImGuiTableSortSpecs* sortSpecs = ImGui::TableGetSortSpecs();
+
+			if (sortSpecs && sortSpecs->SpecsCount > 0 && (isNewSnapshot || sortSpecs->SpecsDirty))
+			{
+				int16_t column     = sortSpecs->Specs[0].ColumnIndex;
+				bool    descending = sortSpecs->Specs[0].SortDirection == ImGuiSortDirection_Descending;
+
+				auto value = [column](const SquadMember_t& aMember) {
+					switch (column)
+					{
+						default: return abs(aMember.Stats.OutTarget.Damage);
+						case 2:  return abs(aMember.Stats.OutCleave.Damage);
+						case 3:  return aMember.Stats.OutCleave.Heal;
+						case 4:  return aMember.Stats.OutCleave.Barrier;
+					}
+				};
+
+				std::sort(s_SquadRows.begin(), s_SquadRows.end(), [&](const SquadMember_t* aLhs, const SquadMember_t* aRhs) {
+					return descending ? value(*aLhs) > value(*aRhs) : value(*aLhs) < value(*aRhs);
+				});
+
+				sortSpecs->SpecsDirty = false;
+			}
+
+			char name[32];
+
+			for (const SquadMember_t* member : s_SquadRows)
+			{
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::Text(member->Agent->GetName(name, sizeof(name)));
+
+				for (float value : { abs(member->Stats.OutTarget.Damage), abs(member->Stats.OutCleave.Damage), member->Stats.OutCleave.Heal, member->Stats.OutCleave.Barrier })
+				{
+					ImGui::TableNextColumn();
+					char perSecond[32];
+					FormatRate(perSecond, sizeof(perSecond), value > 0.f, value, cbtDuration);
+					ImGui::SetCursorPosX(ImGui::GetCursorPosX() + ImGui::GetColumnWidth() - ImGui::CalcTextSize(perSecond).x);
+					ImGui::Text(perSecond);
+				}
+			}
+
+			ImGui::EndTable();
+		}
+	}
+	ImGui::End();
 }
 
-void UiRoot::OnCombatEnd()
+void UiRoot::BuildSkillRows()
 {
-	const std::lock_guard<std::mutex> lock(s_Mutex);
+	s_SkillRows.clear();
+	s_SkillTotal     = HitQuantiles_t{};
+	s_SkillTotalHits = HitCount_t{};
+
+	/* Row of every skill ID, offset by one so absent reads as 0. */
+	FlatMap_t<uint32_t> rowOf;
 
-	/* Only keep last 10 encounters. */
-	while (s_History.size() > 10)
+	auto addEncounter = [&rowOf](Encounter_t* aEncounter)
 	{
-		Encounter_t* delEncounter = s_History.front();
+		aEncounter->Skills.ForEach([&rowOf](uint32_t aID, Skill_t* aSkill)
+		{
+			if (aSkill->Out.Hits == 0) { return; }
+
+			if (uint32_t row = rowOf.Get(aID))
+			{
+				s_SkillRows[row - 1].Metrics.Merge(aSkill->Out);
+			}
+			else
+			{
+				s_SkillRows.push_back(SkillRow_t{ aSkill, aSkill->Out });
+				rowOf.Set(aID, (uint32_t)s_SkillRows.size());
+			}
+		});
 
-		/* Selecting the oldest encounter means you can keep more than 10 encounters in history, but who cares. */
-		if (delEncounter != s_DisplayedEncounter)
+		s_SkillTotal.Merge(aEncounter->OutHits);
+	};
+
+	if (s_SkillsAllHistory)
+	{
+		/* Sketches merge across encounters, the active one is skipped until it is sealed. */
+		for (Encounter_t* encounter : s_History)
 		{
-			DeleteEncounter(delEncounter);
-			s_History.erase(s_History.begin());
+			if (encounter->OutCleaveIndex.IsFinalized)
+			{
+				addEncounter(encounter);
+			}
 		}
 	}
+	else
+	{
+		addEncounter(s_DisplayedEncounter);
+	}
+
+	std::sort(s_SkillRows.begin(), s_SkillRows.end(), [](const SkillRow_t& aLeft, const SkillRow_t& aRight)
+	{
+		return aLeft.Metrics.Damage < aRight.Metrics.Damage;
+	});
+
+	for (const SkillRow_t& row : s_SkillRows)
+	{
+		s_SkillTotalHits.Merge(row.Metrics);
+	}
+
+	s_SkillRowsSource     = s_SkillsAllHistory ? nullptr : s_DisplayedEncounter;
+	s_SkillRowsGeneration = s_HistoryGeneration;
+}
+
+void UiRoot::RenderSkills()
+{
+	const Encounter_t* source = s_SkillsAllHistory ? nullptr : s_DisplayedEncounter;
+
+	if (source != s_SkillRowsSource || s_SkillRowsGeneration != s_HistoryGeneration)
+	{
+		BuildSkillRows();
+	}
+
+	if (s_SkillRows.empty())
+	{
+		ImGui::TextDisabled(Translate(ETexts::NoSkills));
+		return;
+	}
+
+	if (ImGui::BeginTable("Skills", 6, ImGuiTableFlags_RowBg))
+	{
+		ImGui::TableSetupColumn("##Skill", ImGuiTableColumnFlags_WidthStretch);
+		ImGui::TableSetupColumn(Translate(ETexts::Hits));
+		ImGui::TableSetupColumn(Translate(ETexts::CritRate));
+		ImGui::TableSetupColumn(Translate(ETexts::Median));
+		ImGui::TableSetupColumn("p90");
+		ImGui::TableSetupColumn("Max");
+		ImGui::TableHeadersRow();
+
+		auto renderRow = [](const char* aName, uint32_t aHits, float aCritRate, const QuantileSketch_t& aSizes)
+		{
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::Text(aName);
+			ImGui::TableNextColumn();
+			ImGui::Text("%u", aHits);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f%%", aCritRate * 100.f);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.0f", aSizes.Quantile(0.5));
+			ImGui::TableNextColumn();
+			ImGui::Text("%.0f", aSizes.Quantile(0.9));
+			ImGui::TableNextColumn();
+			ImGui::Text("%.0f", aSizes.Max);
+		};
+
+		char name[32];
+
+		for (const SkillRow_t& row : s_SkillRows)
+		{
+			renderRow(row.Skill->GetName(name, sizeof(name)), row.Metrics.Hits, row.Metrics.CritRate(), row.Metrics.HitSizes);
+		}
+
+		renderRow(Translate(ETexts::Total), s_SkillTotalHits.Hits, s_SkillTotalHits.CritRate(), s_SkillTotal.HitSizes);
+
+		ImGui::EndTable();
+	}
+}
+
+void UiRoot::BuildBuffRows()
+{
+	auto buildRows = [](std::vector<const BuffUptime_t*>& aRows, const FlatMap_t<BuffUptime_t*>& aBuffs)
+	{
+		aRows.clear();
+		aBuffs.ForEach([&aRows](uint32_t, BuffUptime_t* aUptime)
+		{
+			if (aUptime->Covered > 0) { aRows.push_back(aUptime); }
+		});
+
+		std::sort(aRows.begin(), aRows.end(), [](const BuffUptime_t* aLeft, const BuffUptime_t* aRight)
+		{
+			return aLeft->Covered > aRight->Covered;
+		});
+	};
+
+	buildRows(s_BuffRowsSelf, s_DisplayedEncounter->BuffsSelf);
+	buildRows(s_BuffRowsTarget, s_DisplayedEncounter->BuffsTarget);
+
+	s_BuffRowsSource     = s_DisplayedEncounter;
+	s_BuffRowsGeneration = s_HistoryGeneration;
+}
+
+void UiRoot::RenderBuffs()
+{
+	uint32_t duration = (uint32_t)max(s_DisplayedEncounter->TimeEnd - s_DisplayedEncounter->TimeStart, 1000);
+
+	if (s_DisplayedEncounter != s_BuffRowsSource || s_BuffRowsGeneration != s_HistoryGeneration)
+	{
+		BuildBuffRows();
+	}
+
+	auto renderTable = [duration](const char* aID, const char* aName, const std::vector<const BuffUptime_t*>& aRows)
+	{
+		if (aRows.empty()) { return; }
+
+		if (ImGui::BeginTable(aID, 4, ImGuiTableFlags_RowBg))
+		{
+			ImGui::TableSetupColumn(aName, ImGuiTableColumnFlags_WidthStretch);
+			ImGui::TableSetupColumn(Translate(ETexts::Uptime));
+			ImGui::TableSetupColumn(Translate(ETexts::Stacks));
+			ImGui::TableSetupColumn(Translate(ETexts::MaxStacks));
+			ImGui::TableHeadersRow();
+
+			char name[32];
+
+			for (const BuffUptime_t* uptime : aRows)
+			{
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::Text(uptime->Buff ? uptime->Buff->GetName(name, sizeof(name)) : "(null)");
+				ImGui::TableNextColumn();
+				ImGui::Text("%.1f%%", uptime->Uptime(duration) * 100.f);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.2f", uptime->AverageStacks(duration));
+				ImGui::TableNextColumn();
+				ImGui::Text("%u", uptime->MaxStacks);
+			}
+
+			ImGui::EndTable();
+		}
+	};
+
+	if (s_BuffRowsSelf.empty() && s_BuffRowsTarget.empty())
+	{
+		ImGui::TextDisabled(Translate(ETexts::NoBuffs));
+		return;
+	}
+
+	renderTable("BuffsSelf", Translate(ETexts::Self), s_BuffRowsSelf);
+
+	/* Only reached on finalized encounters, the agent map is sealed. */
+	char name[32];
+	const char* targetName = Translate(ETexts::Target);
+	if (s_DisplayedEncounter->TriggerID)
+	{
+		targetName = s_DisplayedEncounter->GetTargetName(name, sizeof(name));
+	}
+
+	renderTable("BuffsTarget", targetName, s_BuffRowsTarget);
+}
+
+void UiRoot::RenderComparison()
+{
+	/* Either side may have been evicted meanwhile. */
+	if (std::find(s_History.begin(), s_History.end(), s_CompareWith) == s_History.end() || s_CompareWith == s_DisplayedEncounter
+		|| !s_DisplayedEncounter->OutCleaveIndex.IsFinalized)
+	{
+		s_CompareWith = nullptr;
+		return;
+	}
+
+	char wndName[128];
+	Format::Join(wndName, sizeof(wndName), Translate(ETexts::Compare), "###CMX::Compare");
+
+	bool isOpen = true;
+
+	if (ImGui::Begin(wndName, &isOpen, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoCollapse))
+	{
+		std::shared_ptr<const ComparisonResult_t> result = Comparison::Get(s_DisplayedEncounter, s_CompareWith);
+
+		if (!result)
+		{
+			ImGui::TextDisabled(Translate(ETexts::Computing));
+		}
+		else
+		{
+			float dpsA = result->DamageA / (max(result->DurationA, 1000) / 1000.f);
+			float dpsB = result->DamageB / (max(result->DurationB, 1000) / 1000.f);
+
+			char rate[32];
+			ImGui::Text("%s, %.2fs", Format::Denominated(rate, sizeof(rate), dpsA, "/s"), result->DurationA / 1000.f);
+			ImGui::SameLine();
+			ImGui::TextDisabled("|");
+			ImGui::SameLine();
+			ImGui::Text("%s, %.2fs", Format::Denominated(rate, sizeof(rate), dpsB, "/s"), result->DurationB / 1000.f);
+
+			/* Both curves share one scale so they can be read against each other. */
+			float scaleMax = 0.f;
+			for (const std::vector<float>* curve : { &result->DpsA, &result->DpsB })
+			{
+				for (float dps : *curve) { scaleMax = dps > scaleMax ? dps : scaleMax; }
+			}
+
+			int samples = (int)max(result->DpsA.size(), result->DpsB.size());
+
+			if (samples > 0)
+			{
+				ImGui::PlotLines("##DpsA", result->DpsA.data(), (int)result->DpsA.size(), 0, nullptr, 0.f, scaleMax, ImVec2(samples * 2.f, 60.f));
+				ImGui::PlotLines("##DpsB", result->DpsB.data(), (int)result->DpsB.size(), 0, nullptr, 0.f, scaleMax, ImVec2(samples * 2.f, 60.f));
+			}
+
+			if (ImGui::BeginTable("Comparison", 5, ImGuiTableFlags_RowBg))
+			{
+				ImGui::TableSetupColumn("##Skill", ImGuiTableColumnFlags_WidthStretch);
+				ImGui::TableSetupColumn("A");
+				ImGui::TableSetupColumn("B");
+				ImGui::TableSetupColumn("+/-");
+				ImGui::TableSetupColumn(Translate(ETexts::Share));
+				ImGui::TableHeadersRow();
+
+				char damage[32];
+
+				for (const SkillDelta_t& skill : result->Skills)
+				{
+					float delta = skill.DamageB - skill.DamageA;
+
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					ImGui::Text(skill.Name.c_str());
+					ImGui::TableNextColumn();
+					ImGui::Text(Format::Denominated(damage, sizeof(damage), skill.DamageA));
+					ImGui::TableNextColumn();
+					ImGui::Text(Format::Denominated(damage, sizeof(damage), skill.DamageB));
+					ImGui::TableNextColumn();
+					ImGui::TextColored(delta >= 0.f ? ImVec4(0.f, 1.f, 0.f, 1.f) : ImVec4(1.f, 0.f, 0.f, 1.f),
+						"%s%s", delta >= 0.f ? "+" : "-", Format::Denominated(damage, sizeof(damage), abs(delta)));
+					ImGui::TableNextColumn();
+					ImGui::Text("%.1f%% -> %.1f%%", skill.ShareA * 100.f, skill.ShareB * 100.f);
+				}
+
+				ImGui::EndTable();
+			}
+		}
+	}
+	ImGui::End();
+
+	if (!isOpen)
+	{
+		s_CompareWith = nullptr;
+	}
+}
+
+void UiRoot::RenderSearch()
+{
+	ImGui::InputText("##Search", s_SearchQuery, sizeof(s_SearchQuery));
+
+	/* Filters narrow the history down, only loaded candidates are checked exactly. */
+	if (s_SearchLast != s_SearchQuery)
+	{
+		s_SearchLast = s_SearchQuery;
+		s_SearchHits.clear();
+
+		for (const std::shared_ptr<const EncounterSummary_t>& summary : HistoryIndex::Search(s_SearchLast))
+		{
+			auto it = std::find_if(s_History.begin(), s_History.end(), [&summary](Encounter_t* aEncounter) {
+				return aEncounter->TimeStart == summary->TimeStart && aEncounter->OutCleaveIndex.IsFinalized;
+			});
+
+			if (it == s_History.end())
+			{
+				s_SearchHits.push_back(SearchHit_t{ summary, nullptr });
+			}
+			else if (HistoryIndex::Matches(*it, s_SearchLast))
+			{
+				s_SearchHits.push_back(SearchHit_t{ summary, *it });
+			}
+		}
+	}
+
+	if (s_SearchLast.empty()) { return; }
+
+	if (s_SearchHits.empty())
+	{
+		ImGui::TextDisabled(Translate(ETexts::NoResults));
+		return;
+	}
+
+	for (const SearchHit_t& hit : s_SearchHits)
+	{
+		/* Encounters may have been evicted since the search. */
+		bool isLoaded = hit.Encounter && std::find(s_History.begin(), s_History.end(), hit.Encounter) != s_History.end();
+
+		if (!isLoaded)
+		{
+			ImGui::TextDisabled(hit.Summary->Name.c_str());
+			continue;
+		}
+
+		if (ImGui::Selectable(hit.Summary->Name.c_str(), hit.Encounter == s_DisplayedEncounter))
+		{
+			s_DisplayedEncounter = hit.Encounter;
+			s_DisplayedEncounter->LastAccess = GetTickCount64();
+
+			s_TimeWindow[0] = 0.f;
+			s_TimeWindow[1] = (hit.Encounter->TimeEnd - hit.Encounter->TimeStart) / 1000.f;
+		}
+	}
+}
+
+void UiRoot::Options()
+{
+	int captureMode = (int)Settings::CaptureMode.load();
+	const char* captureModes[] = { Translate(ETexts::CaptureFull), Translate(ETexts::CaptureSelfOnly), Translate(ETexts::CaptureSquad) };
+	if (ImGui::Combo(Translate(ETexts::CaptureMode), &captureMode, captureModes, IM_ARRAYSIZE(captureModes)))
+	{
+		Settings::CaptureMode = (ECaptureMode)captureMode;
+		Settings::Save();
+	}
+
+	int gracePeriod = Settings::InstanceGracePeriod / 1000;
+	if (ImGui::SliderInt(Translate(ETexts::InstanceGracePeriod), &gracePeriod, 0, 30, "%ds"))
+	{
+		Settings::InstanceGracePeriod = gracePeriod * 1000;
+	}
+	if (ImGui::IsItemDeactivatedAfterEdit())
+	{
+		Settings::Save();
+	}
+
+	int memoryBudget = Settings::HistoryMemoryBudget;
+	if (ImGui::SliderInt(Translate(ETexts::HistoryMemoryBudget), &memoryBudget, 8, 1024, "%d MB"))
+	{
+		Settings::HistoryMemoryBudget = memoryBudget;
+	}
+	if (ImGui::IsItemDeactivatedAfterEdit())
+	{
+		Settings::Save();
+
+		const std::lock_guard<std::mutex> lock(s_Mutex);
+		EnforceMemoryBudget();
+	}
+
+	bool spillToDisk = Settings::SpillToDisk;
+	if (ImGui::Checkbox(Translate(ETexts::SpillToDisk), &spillToDisk))
+	{
+		Settings::SpillToDisk = spillToDisk;
+		Settings::Save();
+	}
+
+	/* Finished encounters answer any threshold from their stored gaps. */
+	int activeTimeGap = Settings::ActiveTimeGap / 1000;
+	if (ImGui::SliderInt(Translate(ETexts::ActiveTimeGap), &activeTimeGap, 1, 60, "%ds"))
+	{
+		Settings::ActiveTimeGap = activeTimeGap * 1000;
+	}
+	if (ImGui::IsItemDeactivatedAfterEdit())
+	{
+		Settings::Save();
+	}
+
+	{
+		const std::lock_guard<std::mutex> lock(s_Mutex);
+
+		size_t usage = 0;
+		for (Encounter_t* encounter : s_History)
+		{
+			usage += encounter->MemoryUsage.load(std::memory_order_relaxed);
+		}
+
+		ImGui::TextDisabled("%.2f MB, %u encounters", usage / 1024.f / 1024.f, (uint32_t)s_History.size());
+	}
+
+	ImGui::Separator();
+
+	ImGui::TextDisabled(Translate(ETexts::Latency));
+
+	if (ImGui::BeginTable("Latency", 5))
+	{
+		ImGui::TableSetupColumn("##Name", ImGuiTableColumnFlags_WidthStretch);
+		ImGui::TableSetupColumn("Count", ImGuiTableColumnFlags_WidthStretch);
+		ImGui::TableSetupColumn("p50", ImGuiTableColumnFlags_WidthStretch);
+		ImGui::TableSetupColumn("p99", ImGuiTableColumnFlags_WidthStretch);
+		ImGui::TableSetupColumn("Max", ImGuiTableColumnFlags_WidthStretch);
+		ImGui::TableHeadersRow();
+
+		for (Histogram_t** it = Profiler::All; *it; it++)
+		{
+			Histogram_t* hist = *it;
+
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::Text(hist->Name);
+			ImGui::TableNextColumn();
+			ImGui::Text("%llu", hist->Count.load(std::memory_order_relaxed));
+			ImGui::TableNextColumn();
+			ImGui::Text("%.2fus", hist->Percentile(0.5) / 1000.f);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.2fus", hist->Percentile(0.99) / 1000.f);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.2fus", hist->Max.load(std::memory_order_relaxed) / 1000.f);
+		}
+
+		ImGui::EndTable();
+	}
+
+	if (ImGui::Button(Translate(ETexts::ExportCSV)))
+	{
+		std::string path = s_APIDefs->Paths_GetAddonDirectory("CombatMetrics/latency.csv");
+
+		if (Profiler::DumpCSV(path.c_str()))
+		{
+			s_APIDefs->Log(LOGL_INFO, ADDON_NAME, String::Format("Latency written to %s.", path.c_str()).c_str());
+		}
+		else
+		{
+			s_APIDefs->Log(LOGL_WARNING, ADDON_NAME, "Could not write latency.");
+		}
+	}
+
+	ImGui::SameLine();
+
+	if (ImGui::Button(Translate(ETexts::Reset)))
+	{
+		for (Histogram_t** it = Profiler::All; *it; it++)
+		{
+			(*it)->Reset();
+		}
+	}
+}
+
+void UiRoot::OnCombatEnd()
+{
+	const std::lock_guard<std::mutex> lock(s_Mutex);
+
+	/* The latest encounter is sealed now. */
+	s_HistoryGeneration++;
 
 	/* Reset displayed to null dummy. */
 	s_DisplayedEncounter = &s_NullEncounter;
@@ -314,8 +1244,20 @@ void UiRoot::OnCombatEnd()
 		if (s_DisplayedEncounter == &s_NullEncounter && s_History.size() > 0)
 		{
 			s_DisplayedEncounter = s_History.back();
+			s_DisplayedEncounter->LastAccess = GetTickCount64();
+
+			s_TimeWindow[0] = 0.f;
+			s_TimeWindow[1] = (s_DisplayedEncounter->TimeEnd - s_DisplayedEncounter->TimeStart) / 1000.f;
 		}
 	}
+
+	EnforceMemoryBudget();
+}
+
+void UiRoot::OnMemoryUsage()
+{
+	const std::lock_guard<std::mutex> lock(s_Mutex);
+	EnforceMemoryBudget();
 }
 
 void UiRoot::OnCombatEvent()
@@ -335,7 +1277,9 @@ void UiRoot::OnCombatEvent()
 
 	if (it == s_History.end())
 	{
+		current->LastAccess = GetTickCount64();
 		s_History.push_back(current);
+		s_HistoryGeneration++;
 	}
 
 	if (s_DisplayedEncounter == &s_NullEncounter)
@@ -343,3 +1287,45 @@ void UiRoot::OnCombatEvent()
 		s_DisplayedEncounter = current;
 	}
 }
+
+void UiRoot::EnforceMemoryBudget()
+{
+	size_t budget = (size_t)Settings::HistoryMemoryBudget * 1024 * 1024;
+
+	Encounter_t* current = Combat::GetCurrentEncounter();
+
+	/* Sampled sizes, the running encounter is resized by the ingest while this runs. */
+	size_t usage = 0;
+	for (Encounter_t* encounter : s_History)
+	{
+		usage += encounter->MemoryUsage.load(std::memory_order_relaxed);
+	}
+
+	/* The running encounter counts before its first notification added it. */
+	if (current && std::find(s_History.begin(), s_History.end(), current) == s_History.end())
+	{
+		usage += current->MemoryUsage.load(std::memory_order_relaxed);
+	}
+
+	while (usage > budget)
+	{
+		/* Evict the least recently displayed encounter, never the displayed or running one. */
+		auto victim = s_History.end();
+		for (auto it = s_History.begin(); it != s_History.end(); it++)
+		{
+			if (*it == s_DisplayedEncounter || *it == current) { continue; }
+
+			if (victim == s_History.end() || (*it)->LastAccess < (*victim)->LastAccess)
+			{
+				victim = it;
+			}
+		}
+
+		/* Only protected encounters left. */
+		if (victim == s_History.end()) { break; }
+
+		usage -= (*victim)->MemoryUsage.load(std::memory_order_relaxed);
+		DeleteEncounter(*victim);
+		s_History.erase(victim);
+	}
+}
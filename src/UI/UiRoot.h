@@ -13,4 +13,7 @@ namespace UiRoot
 	void Options();
 
 	void OnCombatEnd();
+
+	/* Evicts old encounters if the history grew past the budget. Called by the ingest. */
+	void OnMemoryUsage();
 }